@@ -0,0 +1,108 @@
+// replay cache traces through lru_cache, two_queue_cache, arc_cache and tinylfu_cache
+// build: g++ -std=c++17 -O2 -I.. cache_trace.cpp -o cache_trace
+// usage: cache_trace <capacity> <trace>...   replay every trace at the given capacity
+//        cache_trace --gen <trace>           write a zipf trace interrupted by scans
+// a trace has one request per line, the first token is the key. a numeric
+// second token counts consecutive keys, as in the ARC .lis traces.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "lru_cache.hpp"
+#include "cache_policy.hpp"
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool readTrace(const char *path, std::vector<unsigned long long> &keys)
+{
+	FILE *f = fopen(path, "r");
+	if (!f) return false;
+	char line[4096], key[4096];
+	while (fgets(line, sizeof(line), f)) {
+		long long count = 1;
+		if (sscanf(line, "%4095s %lld", key, &count) < 1) continue;
+		char *end;
+		unsigned long long k = strtoull(key, &end, 10);
+		if (*end) {
+			k = std::hash<std::string>()(key);
+			count = 1;
+		}
+		for (long long i = 0; i < std::max(count, 1LL); ++i) keys.push_back(k + i);
+	}
+	fclose(f);
+	return true;
+}
+
+// zipf(0.9) requests over 100k hot keys, and every 1M requests a scan of 200k fresh keys
+void writeTrace(const char *path)
+{
+	const int HOT = 100000, REQUESTS = 4000000, PERIOD = 1000000, SCAN = 200000;
+	std::vector<double> cdf(HOT);
+	double sum = 0;
+	for (int i = 0; i < HOT; ++i) cdf[i] = sum += 1 / pow(i + 1, 0.9);
+	FILE *f = fopen(path, "w");
+	unsigned long long fresh = 1ULL << 40;
+	for (int i = 0; i < REQUESTS; ++i) {
+		if (i % PERIOD == PERIOD / 2)
+			for (int j = 0; j < SCAN; ++j) fprintf(f, "%llu\n", fresh++);
+		double u = (nextRand() >> 11) * (1.0 / (1ULL << 53)) * sum;
+		fprintf(f, "%d\n", (int)(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()));
+	}
+	fclose(f);
+}
+
+template<class Cache>
+void replay(const char *name, size_t capacity, const std::vector<unsigned long long> &keys)
+{
+	Cache cache(capacity);
+	long long t = now();
+	for (unsigned long long k : keys)
+		if (!cache.get(k)) cache.put(k, 0);
+	t = now() - t;
+	printf("  %-16s hit ratio %6.2f%%  %6lld ms\n", name, cache.stats().hit_ratio() * 100, t);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3 && !strcmp(argv[1], "--gen")) {
+		writeTrace(argv[2]);
+		return 0;
+	}
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <capacity> <trace>...\n       %s --gen <trace>\n", argv[0], argv[0]);
+		return 1;
+	}
+	size_t capacity = strtoull(argv[1], nullptr, 10);
+	for (int i = 2; i < argc; ++i) {
+		std::vector<unsigned long long> keys;
+		if (!readTrace(argv[i], keys)) {
+			fprintf(stderr, "cannot read %s\n", argv[i]);
+			continue;
+		}
+		printf("%s: %zu requests, capacity %zu\n", argv[i], keys.size(), capacity);
+		replay<sjtu::lru_cache<unsigned long long, int>>("lru_cache", capacity, keys);
+		replay<sjtu::two_queue_cache<unsigned long long, int>>("two_queue_cache", capacity, keys);
+		replay<sjtu::arc_cache<unsigned long long, int>>("arc_cache", capacity, keys);
+		replay<sjtu::tinylfu_cache<unsigned long long, int>>("tinylfu_cache", capacity, keys);
+	}
+	return 0;
+}
@@ -0,0 +1,118 @@
+// throughput of concurrent_linked_hashmap against one mutex around linked_hashmap
+// and against shards behind reader/writer locks, 1-64 threads
+// build: g++ -std=c++17 -O2 -pthread -I.. concurrent_map.cpp -o concurrent_map
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+#include "concurrent_linked_hashmap.hpp"
+
+const int KEYS = 1000000;
+const int OPS_PER_THREAD = 500000;
+const int THREADS[] = {1, 2, 4, 8, 16, 32, 64};
+// inserts and erases out of 1000 operations, the rest are finds
+struct mix {
+	const char *name;
+	int inserts, erases;
+};
+const mix MIXES[] = {{"90% find", 50, 50}, {"99% find", 5, 5}};
+
+// a global mutex around linked_hashmap, the baseline we want to beat
+struct locked_map {
+	std::mutex lock;
+	sjtu::linked_hashmap<unsigned long long, unsigned long long> map;
+	bool find(unsigned long long key, unsigned long long &out) {
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = map.find(key);
+		if (it == map.end()) return false;
+		out = it->second;
+		return true;
+	}
+	bool insert(unsigned long long key, unsigned long long value) {
+		std::lock_guard<std::mutex> guard(lock);
+		return map.insert(sjtu::pair<const unsigned long long, unsigned long long>(key, value)).second;
+	}
+	bool erase(unsigned long long key) {
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = map.find(key);
+		if (it == map.end()) return false;
+		map.erase(it);
+		return true;
+	}
+};
+
+// 64 linked_hashmap behind a shared_mutex each, readers lock too
+struct rwlock_map {
+	struct alignas(64) shard {
+		std::shared_mutex lock;
+		sjtu::linked_hashmap<unsigned long long, unsigned long long> map;
+	};
+	shard shards[64];
+	shard &of(unsigned long long key) {return shards[(key * 0x9e3779b97f4a7c15ULL) >> 58];}
+	bool find(unsigned long long key, unsigned long long &out) {
+		shard &s = of(key);
+		std::shared_lock<std::shared_mutex> guard(s.lock);
+		const auto &m = s.map;
+		auto it = m.find(key);
+		if (it == m.cend()) return false;
+		out = it->second;
+		return true;
+	}
+	bool insert(unsigned long long key, unsigned long long value) {
+		shard &s = of(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		return s.map.insert(sjtu::pair<const unsigned long long, unsigned long long>(key, value)).second;
+	}
+	bool erase(unsigned long long key) {
+		shard &s = of(key);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+		auto it = s.map.find(key);
+		if (it == s.map.end()) return false;
+		s.map.erase(it);
+		return true;
+	}
+};
+
+template<class Map>
+double throughput(Map &m, int threads, const mix &x)
+{
+	for (int i = 0; i < KEYS; i += 2) m.insert(i, i);
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; ++t)
+		workers.emplace_back([&m, t, &x]() {
+			unsigned long long s = t * 7919 + 1, out = 0;
+			for (int i = 0; i < OPS_PER_THREAD; ++i) {
+				s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+				unsigned long long key = (s >> 33) % KEYS;
+				int op = (s >> 20) % 1000;
+				if (op < x.inserts) m.insert(key, i);
+				else if (op < x.inserts + x.erases) m.erase(key);
+				else m.find(key, out);
+			}
+		});
+	for (auto &w : workers) w.join();
+	double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return (double)threads * OPS_PER_THREAD / sec / 1e6;
+}
+
+int main()
+{
+	printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+	for (const mix &x : MIXES) {
+		printf("%s, Mops/s\nthreads   one mutex   rwlock shards   concurrent_linked_hashmap\n", x.name);
+		for (int threads : THREADS) {
+			locked_map a;
+			rwlock_map *b = new rwlock_map;
+			sjtu::concurrent_linked_hashmap<unsigned long long, unsigned long long> c;
+			double ta = throughput(a, threads, x), tb = throughput(*b, threads, x), tc = throughput(c, threads, x);
+			delete b;
+			printf("%7d   %9.2f   %13.2f   %25.2f\n", threads, ta, tb, tc);
+		}
+	}
+	return 0;
+}
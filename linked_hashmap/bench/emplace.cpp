@@ -0,0 +1,55 @@
+// inserting values which own heap memory into linked_hashmap: insert of a temporary pair,
+// operator[] then assignment, try_emplace and insert_or_assign
+// build: g++ -std=c++17 -O2 -I.. emplace.cpp -o emplace
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+
+const int N = 1000000;
+const int ROUNDS = 3;
+// ints in every value, 256 bytes on the heap
+const int WIDTH = 64;
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+using map = sjtu::linked_hashmap<int, std::vector<int>>;
+
+template<class F>
+long long timed(F f, unsigned long long &sum)
+{
+	long long total = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		map m;
+		long long t = now();
+		f(m);
+		total += now() - t;
+		sum += m.size();
+	}
+	return total / ROUNDS;
+}
+
+int main()
+{
+	unsigned long long sum = 0;
+	long long insertT = timed([](map &m) {
+		for (int i = 0; i < N; ++i) m.insert(map::value_type(i, std::vector<int>(WIDTH, i)));
+	}, sum);
+	long long indexT = timed([](map &m) {
+		for (int i = 0; i < N; ++i) m[i] = std::vector<int>(WIDTH, i);
+	}, sum);
+	long long emplaceT = timed([](map &m) {
+		for (int i = 0; i < N; ++i) m.try_emplace(i, WIDTH, i);
+	}, sum);
+	long long assignT = timed([](map &m) {
+		for (int i = 0; i < N; ++i) m.insert_or_assign(i, std::vector<int>(WIDTH, i));
+	}, sum);
+	printf("insert %5lld  operator[] %5lld  try_emplace %5lld  insert_or_assign %5lld ms  (%llu)\n",
+		insertT, indexT, emplaceT, assignT, sum % 10);
+	return 0;
+}
@@ -0,0 +1,47 @@
+// eviction loop: erase the oldest entry through its iterator while inserting new ones
+// build: g++ -std=c++17 -O2 -I.. erase_iterator.cpp -o erase_iterator
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "linked_hashmap.hpp"
+
+const int LIVE = 500000;
+const int CHURN = 3000000;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string keys[LIVE + CHURN];
+
+int main()
+{
+	for (int i = 0; i < LIVE + CHURN; ++i)
+		keys[i] = "/api/v1/sessions/user/" + std::to_string(nextRand());
+	sjtu::linked_hashmap<std::string, int> m;
+	for (int i = 0; i < LIVE; ++i) m[keys[i]] = i;
+
+	long long t = now();
+	for (int i = LIVE; i < LIVE + CHURN; ++i) {
+		m.erase(m.begin());
+		m[keys[i]] = i;
+	}
+	long long churnT = now() - t;
+	t = now();
+	while (!m.empty()) m.erase(m.begin());
+	long long drainT = now() - t;
+	printf("%d evict + insert %lld ms, draining %d entries %lld ms\n", CHURN, churnT, LIVE, drainT);
+	return 0;
+}
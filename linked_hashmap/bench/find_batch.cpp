@@ -0,0 +1,76 @@
+// random probes of linked_hashmap one find() at a time against find_batch and count_batch,
+// from a table inside the cache to one several times larger than the last level cache
+// build: g++ -std=c++17 -O2 -I.. find_batch.cpp -o find_batch
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+
+const int SIZES[] = {100000, 1000000, 8000000};
+const int PROBES = 10000000;
+// keys per call of the batch functions, like the probe side of a join handing over a block
+const int CHUNK = 1024;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+using map = sjtu::linked_hashmap<unsigned long long, unsigned long long>;
+
+int main()
+{
+	std::vector<unsigned long long> probes(PROBES);
+	std::vector<map::iterator> found(CHUNK);
+	for (int size : SIZES) {
+		map m;
+		for (int i = 0; i < size; ++i) m[nextRand()] = i;
+		// half of the probes hit, in random order
+		std::vector<unsigned long long> keys;
+		for (map::iterator it = m.begin(); it != m.end(); ++it) keys.push_back(it->first);
+		for (int i = 0; i < PROBES; ++i)
+			probes[i] = i % 2 ? keys[nextRand() % size] : nextRand();
+
+		unsigned long long sum = 0;
+		long long t = now();
+		for (int i = 0; i < PROBES; ++i) sum += m.count(probes[i]);
+		long long countT = now() - t;
+
+		t = now();
+		for (int i = 0; i < PROBES; i += CHUNK)
+			sum += m.count_batch(probes.data() + i, std::min(CHUNK, PROBES - i));
+		long long countBatchT = now() - t;
+
+		t = now();
+		for (int i = 0; i < PROBES; ++i) {
+			map::iterator it = m.find(probes[i]);
+			if (it != m.end()) sum += it->second;
+		}
+		long long findT = now() - t;
+
+		t = now();
+		for (int i = 0; i < PROBES; i += CHUNK) {
+			int n = std::min(CHUNK, PROBES - i);
+			m.find_batch(probes.data() + i, n, found.data());
+			for (int j = 0; j < n; ++j)
+				if (found[j] != m.end()) sum += found[j]->second;
+		}
+		long long findBatchT = now() - t;
+
+		printf("%8d keys  count %5lld  count_batch %5lld  find %5lld  find_batch %5lld ms  (%llu)\n",
+			size, countT, countBatchT, findT, findBatchT, sum % 10);
+	}
+	return 0;
+}
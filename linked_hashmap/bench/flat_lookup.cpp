@@ -0,0 +1,67 @@
+// insert, hit, miss, erase and iteration time of linked_hashmap and flat_linked_hashmap
+// build: g++ -std=c++17 -O2 -I.. flat_lookup.cpp -o flat_lookup
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+#include "flat_linked_hashmap.hpp"
+
+const int N = 1000000;
+const int ROUNDS = 3;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long long keys[N];
+
+template<class Map>
+void run(const char *name)
+{
+	long long insertT = 0, hitT = 0, missT = 0, eraseT = 0, iterT = 0;
+	unsigned long long sum = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		Map m;
+		long long t = now();
+		for (int i = 0; i < N; ++i) m[keys[i]] = i;
+		insertT += now() - t;
+
+		t = now();
+		for (int i = 0; i < N; ++i) sum += m.find(keys[(i * 7919LL) % N])->second;
+		hitT += now() - t;
+
+		t = now();
+		for (int i = 0; i < N; ++i) sum += m.count(keys[i] ^ 1);
+		missT += now() - t;
+
+		t = now();
+		for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+		iterT += now() - t;
+
+		t = now();
+		for (int i = 0; i < N; i += 2) m.erase(m.find(keys[i]));
+		eraseT += now() - t;
+	}
+	printf("%-20s insert %5lld  hit %5lld  miss %5lld  iterate %5lld  erase %5lld ms  (%llu)\n",
+		name, insertT / ROUNDS, hitT / ROUNDS, missT / ROUNDS, iterT / ROUNDS, eraseT / ROUNDS, sum % 10);
+}
+
+int main()
+{
+	// even keys only, so keys[i] ^ 1 always misses
+	for (int i = 0; i < N; ++i) keys[i] = nextRand() & ~1ULL;
+	run<sjtu::linked_hashmap<unsigned long long, int>>("linked_hashmap");
+	run<sjtu::flat_linked_hashmap<unsigned long long, int>>("flat_linked_hashmap");
+	return 0;
+}
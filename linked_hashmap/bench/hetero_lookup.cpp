@@ -0,0 +1,93 @@
+// lookups by const char * in linked_hashmap and flat_linked_hashmap with std::string keys,
+// through a temporary std::string against transparent hash and equal taking a string_view
+// build: g++ -std=c++17 -O2 -I.. hetero_lookup.cpp -o hetero_lookup
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+#include "flat_linked_hashmap.hpp"
+
+const int N = 1000000;
+const int ROUNDS = 3;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// std::hash<std::string> and std::hash<std::string_view> agree on equal contents
+struct string_hash {
+	typedef void is_transparent;
+	size_t operator()(std::string_view s) const {return std::hash<std::string_view>()(s);}
+};
+struct string_equal {
+	typedef void is_transparent;
+	bool operator()(std::string_view a, std::string_view b) const {return a == b;}
+};
+
+std::vector<std::string> keys;
+// the lookups arrive as c strings, as from a parser or a network buffer
+std::vector<const char *> queries;
+
+template<class Map>
+long long byString(const Map &m, unsigned long long &sum)
+{
+	long long t = now();
+	for (int i = 0; i < N; ++i) sum += m.count(std::string(queries[i]));
+	return now() - t;
+}
+
+template<class Map>
+long long byView(const Map &m, unsigned long long &sum)
+{
+	long long t = now();
+	for (int i = 0; i < N; ++i) sum += m.count(std::string_view(queries[i]));
+	return now() - t;
+}
+
+template<class Plain, class Transparent>
+void run(const char *name)
+{
+	long long plainT = 0, viewT = 0;
+	unsigned long long sum = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		Plain a;
+		Transparent b;
+		for (int i = 0; i < N; i += 2) {
+			a[keys[i]] = i;
+			b[keys[i]] = i;
+		}
+		plainT += byString(a, sum);
+		viewT += byView(b, sum);
+	}
+	printf("%-20s  std::string %5lld  string_view %5lld ms  (%llu)\n",
+		name, plainT / ROUNDS, viewT / ROUNDS, sum % 10);
+}
+
+int main()
+{
+	// longer than the small string buffer, so every temporary std::string allocates
+	for (int i = 0; i < N; ++i)
+		keys.push_back("/api/v1/sessions/user/" + std::to_string(nextRand()));
+	for (int i = 0; i < N; ++i)
+		queries.push_back(keys[nextRand() % N].c_str());
+	run<sjtu::linked_hashmap<std::string, int>,
+		sjtu::linked_hashmap<std::string, int, string_hash, string_equal>>("linked_hashmap");
+	run<sjtu::flat_linked_hashmap<std::string, int>,
+		sjtu::flat_linked_hashmap<std::string, int, string_hash, string_equal>>("flat_linked_hashmap");
+	return 0;
+}
@@ -0,0 +1,75 @@
+// insert, hit and miss time of linked_hashmap under each IndexPolicy, on sequential and random int keys
+// build: g++ -std=c++17 -O2 -I.. index_policy.cpp -o index_policy
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+
+const int N = 2000000;
+const int ROUNDS = 3;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long keys[N];
+
+// n keys, every lookup pass repeated reps times
+template<class Policy>
+void run(const char *name, const char *keyName, int n, int reps)
+{
+	long long insertT = 0, hitT = 0, missT = 0;
+	unsigned long long sum = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		sjtu::linked_hashmap<long long, int, std::hash<long long>, std::equal_to<long long>, Policy> m;
+		long long t = now();
+		for (int i = 0; i < n; ++i) m[keys[i]] = i;
+		insertT += now() - t;
+
+		t = now();
+		for (int k = 0; k < reps; ++k)
+			for (int i = 0; i < n; ++i) sum += m.at(keys[i]);
+		hitT += now() - t;
+
+		t = now();
+		for (int k = 0; k < reps; ++k)
+			for (int i = 0; i < n; ++i) sum += m.count(-keys[i] - 1);
+		missT += now() - t;
+	}
+	printf("%-10s %-22s insert %5lld  hit %5lld  miss %5lld ms  (%llu)\n",
+		keyName, name, insertT / ROUNDS, hitT / ROUNDS, missT / ROUNDS, sum % 10);
+}
+
+template<class Policy>
+void both(const char *name)
+{
+	for (int i = 0; i < N; ++i) keys[i] = i;
+	run<Policy>(name, "sequential", N, 1);
+	// strided keys leave the low bits constant, the worst case for a plain mask
+	for (int i = 0; i < N; ++i) keys[i] = (long long)i << 12;
+	run<Policy>(name, "stride4096", N, 1);
+	seed = 19260817;
+	for (int i = 0; i < N; ++i) keys[i] = (long long)(nextRand() >> 2);
+	run<Policy>(name, "random", N, 1);
+	// a table that stays in cache, where the division is the bottleneck
+	run<Policy>(name, "random 16k", 16384, N / 16384);
+}
+
+int main()
+{
+	both<sjtu::prime_mod_policy>("prime_mod_policy");
+	both<sjtu::pow2_fibonacci_policy>("pow2_fibonacci_policy");
+	both<sjtu::pow2_murmur_policy>("pow2_murmur_policy");
+	return 0;
+}
@@ -0,0 +1,49 @@
+// latency histogram of single linked_hashmap insertions, shows the stalls of rehashing
+// build: g++ -std=c++17 -O2 -I.. insert_latency.cpp -o insert_latency
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+
+const int N = 8000000;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long lat[N];
+
+int main()
+{
+	sjtu::linked_hashmap<unsigned long long, int> m;
+	// power-of-two buckets of latency: [1, 2) ns, [2, 4) ns, ...
+	long long hist[64] = {0};
+	long long total = nowNs();
+	for (int i = 0; i < N; ++i) {
+		unsigned long long key = nextRand();
+		long long t = nowNs();
+		m[key] = i;
+		lat[i] = nowNs() - t;
+		++hist[63 - __builtin_clzll(lat[i] | 1)];
+	}
+	total = nowNs() - total;
+	std::sort(lat, lat + N);
+	printf("%d inserts in %lld ms\n", N, total / 1000000);
+	printf("p50 %lld  p99 %lld  p99.9 %lld  p99.99 %lld  max %lld ns\n",
+		lat[N / 2], lat[N / 100 * 99], lat[N / 1000 * 999], lat[N / 10000 * 9999], lat[N - 1]);
+	for (int b = 0; b < 64; ++b)
+		if (hist[b]) printf("  [%12lld, %12lld) ns  %lld\n", 1LL << b, 2LL << b, hist[b]);
+	return 0;
+}
@@ -0,0 +1,70 @@
+// bulk load of linked_hashmap with and without reserve(), under two max load factors,
+// and the bucket array left after erasing everything with and without min_load_factor
+// build: g++ -std=c++17 -O2 -I.. reserve.cpp -o reserve
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+
+const int N = 4000000;
+const int ROUNDS = 3;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+using map = sjtu::linked_hashmap<unsigned long long, int>;
+
+unsigned long long keys[N];
+
+long long load(float ml, bool reserve, unsigned long long &sum)
+{
+	long long total = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		map m;
+		m.max_load_factor(ml);
+		long long t = now();
+		if (reserve) m.reserve(N);
+		for (int i = 0; i < N; ++i) m[keys[i]] = i;
+		total += now() - t;
+		sum += m.bucket_count();
+	}
+	return total / ROUNDS;
+}
+
+// erase every element one by one, return the bucket array left behind in KB
+size_t drain(float minLoad, long long &time)
+{
+	map m;
+	m.min_load_factor(minLoad);
+	for (int i = 0; i < N; ++i) m[keys[i]] = i;
+	long long t = now();
+	while (!m.empty()) m.erase(m.begin());
+	time = now() - t;
+	return m.bucket_count() * sizeof(void *) / 1024;
+}
+
+int main()
+{
+	for (int i = 0; i < N; ++i) keys[i] = nextRand();
+	unsigned long long sum = 0;
+	for (float ml : {0.75f, 1.5f})
+		printf("max_load_factor %.2f  no reserve %5lld  reserve %5lld ms\n",
+			ml, load(ml, false, sum), load(ml, true, sum));
+	long long keepT, shrinkT;
+	size_t keep = drain(0, keepT), shrink = drain(0.1f, shrinkT);
+	printf("drained  min_load_factor 0: %7zu KB in %5lld ms  0.1: %7zu KB in %5lld ms  (%llu)\n",
+		keep, keepT, shrink, shrinkT, sum % 10);
+	return 0;
+}
@@ -0,0 +1,79 @@
+// full-map scan time after insert/erase churn, linked_hashmap vs flat_linked_hashmap
+// build: g++ -std=c++17 -O2 -I.. scan.cpp -o scan
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+#include "flat_linked_hashmap.hpp"
+
+const int LIVE = 200000;
+const int CHURN = 4000000;
+const int SCANS = 50;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long long ring[LIVE];
+
+// keep LIVE keys alive, replacing a random one CHURN times
+template<class Map>
+void churn(Map &m)
+{
+	seed = 19260817;
+	for (int i = 0; i < LIVE; ++i) m[ring[i] = nextRand()] = i;
+	for (int i = 0; i < CHURN; ++i) {
+		int j = nextRand() % LIVE;
+		m.erase(m.find(ring[j]));
+		m[ring[j] = nextRand()] = i;
+	}
+}
+
+template<class Map>
+void scan(const char *name, Map &m, long long churnT)
+{
+	unsigned long long sum = 0;
+	long long t = now();
+	for (int s = 0; s < SCANS; ++s)
+		for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+	t = now() - t;
+	printf("%-28s churn %5lld ms  %d scans %5lld ms  %7.2f ns/entry  (%llu)\n",
+		name, churnT, SCANS, t, t * 1e6 / SCANS / LIVE, sum % 10);
+}
+
+int main()
+{
+	{
+		sjtu::linked_hashmap<unsigned long long, int> m;
+		long long t = now();
+		churn(m);
+		scan("linked_hashmap", m, now() - t);
+	}
+	{
+		sjtu::flat_linked_hashmap<unsigned long long, int> m;
+		long long t = now();
+		churn(m);
+		scan("flat, compact at 25%", m, now() - t);
+		printf("%28s tombstones %zu\n", "", m.tombstones());
+	}
+	{
+		sjtu::flat_linked_hashmap<unsigned long long, int> m;
+		m.set_compact_percent(101);
+		long long t = now();
+		churn(m);
+		scan("flat, never compact", m, now() - t);
+		printf("%28s tombstones %zu\n", "", m.tombstones());
+	}
+	return 0;
+}
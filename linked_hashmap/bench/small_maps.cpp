@@ -0,0 +1,51 @@
+// a million tiny linked_hashmaps, like per-request header maps: heap in use and time
+// to build them, look every key up and destroy them, at 4, 8 and 16 entries each
+// build: g++ -std=c++17 -O2 -I.. small_maps.cpp -o small_maps
+#include <chrono>
+#include <cstdio>
+#include <malloc.h>
+#include <string>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+
+const int MAPS = 1000000;
+const int SIZES[] = {4, 8, 16};
+const char *NAMES[] = {"host", "accept", "cookie", "referer", "user-agent", "connection", "cache-control", "content-type",
+	"content-length", "origin", "pragma", "range", "te", "upgrade", "via", "warning"};
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+using map = sjtu::linked_hashmap<std::string, int>;
+
+int main()
+{
+	std::vector<std::string> names(NAMES, NAMES + 16);
+	for (int size : SIZES) {
+		size_t before = mallinfo2().uordblks;
+		long long t = now();
+		std::vector<map> maps(MAPS);
+		for (int i = 0; i < MAPS; ++i)
+			for (int j = 0; j < size; ++j) maps[i][names[j]] = i + j;
+		long long buildT = now() - t;
+		size_t bytes = mallinfo2().uordblks - before;
+
+		t = now();
+		unsigned long long sum = 0;
+		for (int i = 0; i < MAPS; ++i)
+			for (int j = 0; j < size; ++j) sum += maps[i].at(names[j]);
+		long long findT = now() - t;
+
+		t = now();
+		maps.clear();
+		maps.shrink_to_fit();
+		long long freeT = now() - t;
+		printf("%2d entries  %4zu bytes/map  build %5lld  find %5lld  destroy %5lld ms  (%llu)\n",
+			size, bytes / MAPS, buildT, findT, freeT, sum % 10);
+	}
+	return 0;
+}
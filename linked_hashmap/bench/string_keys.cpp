@@ -0,0 +1,60 @@
+// insert (with every rehash), hit and miss time of linked_hashmap with long string keys
+// build: g++ -std=c++17 -O2 -I.. string_keys.cpp -o string_keys
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "linked_hashmap.hpp"
+
+const int N = 1000000;
+const int ROUNDS = 3;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string keys[N], missing[N];
+
+int main()
+{
+	// a long common prefix makes every equal() call expensive
+	for (int i = 0; i < N; ++i) {
+		keys[i] = "/api/v1/sessions/user/" + std::to_string(nextRand());
+		missing[i] = keys[i] + "#";
+	}
+	long long insertT = 0, hitT = 0, missT = 0, copyT = 0;
+	unsigned long long sum = 0;
+	for (int r = 0; r < ROUNDS; ++r) {
+		sjtu::linked_hashmap<std::string, int> m;
+		long long t = now();
+		for (int i = 0; i < N; ++i) m[keys[i]] = i;
+		insertT += now() - t;
+
+		t = now();
+		for (int i = 0; i < N; ++i) sum += m.at(keys[(i * 7919LL) % N]);
+		hitT += now() - t;
+
+		t = now();
+		for (int i = 0; i < N; ++i) sum += m.count(missing[i]);
+		missT += now() - t;
+
+		t = now();
+		sjtu::linked_hashmap<std::string, int> c(m);
+		copyT += now() - t;
+		sum += c.size();
+	}
+	printf("insert %5lld  hit %5lld  miss %5lld  copy %5lld ms  (%llu)\n",
+		insertT / ROUNDS, hitT / ROUNDS, missT / ROUNDS, copyT / ROUNDS, sum % 10);
+	return 0;
+}
@@ -0,0 +1,59 @@
+// expiring sessions with a uniform ttl: ttl_linked_hashmap::expire against a periodic full scan
+// build: g++ -std=c++17 -O2 -I.. ttl_expire.cpp -o ttl_expire
+#include <chrono>
+#include <cstdio>
+
+#include "linked_hashmap.hpp"
+#include "ttl_linked_hashmap.hpp"
+
+const int TICKS = 2000;
+const int PER_TICK = 1000;
+const unsigned long long TTL = 600;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main()
+{
+	// every tick PER_TICK new sessions arrive and the expired ones are removed
+	{
+		seed = 19260817;
+		sjtu::ttl_linked_hashmap<unsigned long long, int> m(TTL);
+		size_t erased = 0;
+		long long t = now();
+		for (unsigned long long tick = 1; tick <= TICKS; ++tick) {
+			for (int i = 0; i < PER_TICK; ++i) m.put(nextRand(), i);
+			erased += m.expire(tick, ~(size_t)0);
+		}
+		printf("ttl_linked_hashmap::expire  %6lld ms  erased %zu  live %zu\n", now() - t, erased, m.size());
+	}
+	{
+		seed = 19260817;
+		sjtu::linked_hashmap<unsigned long long, sjtu::expiring<int>> m;
+		size_t erased = 0;
+		long long t = now();
+		for (unsigned long long tick = 1; tick <= TICKS; ++tick) {
+			for (int i = 0; i < PER_TICK; ++i) m[nextRand()] = sjtu::expiring<int>(i, tick - 1 + TTL);
+			for (auto it = m.begin(); it != m.end(); )
+				if (it->second.deadline <= tick) {
+					m.erase(it++);
+					++erased;
+				}
+				else ++it;
+		}
+		printf("linked_hashmap full scan    %6lld ms  erased %zu  live %zu\n", now() - t, erased, m.size());
+	}
+	return 0;
+}
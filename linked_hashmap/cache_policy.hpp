@@ -0,0 +1,458 @@
+/**
+ * scan resistant caches on top of linked_hashmap: 2Q, ARC and W-TinyLFU
+ */
+#ifndef SJTU_CACHE_POLICY_HPP
+#define SJTU_CACHE_POLICY_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include "linked_hashmap.hpp"
+#include "lru_cache.hpp"
+
+namespace sjtu {
+
+/**
+ * a queue of keys with values, in the order of linked_hashmap.
+ * find, touch (move to the back), push_back, pop_front and erase by key
+ * are all O(1); the caches below are built from a few of these.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class cache_queue : private linked_hashmap<Key, T, Hash, Equal> {
+	private:
+		using map_type = linked_hashmap<Key, T, Hash, Equal>;
+		using hash_node = typename map_type::hash_node;
+		using value_type = typename map_type::value_type;
+
+	public:
+		/**
+		 * the value of key, nullptr if key is not queued.
+		 */
+		T * find(const Key &key) const
+		{
+			hash_node *p = this->_find(key);
+			return p ? &p->data.second : nullptr;
+		}
+		/**
+		 * move key to the back, return its value, nullptr if key is not queued.
+		 */
+		T * touch(const Key &key)
+		{
+			hash_node *p = this->_find(key);
+			if (!p) return nullptr;
+			if (p->nex != this->tail)
+				this->privateinsert(this->tail, this->privateerase(p));
+			return &p->data.second;
+		}
+		/**
+		 * queue key at the back, provided it is not queued yet.
+		 */
+		T * push_back(const Key &key, const T &value)
+		{
+			return &this->_insert(value_type(key, value))->data.second;
+		}
+		bool erase(const Key &key)
+		{
+			hash_node *p = this->_find(key);
+			if (!p) return false;
+			map_type::erase(typename map_type::iterator(p, this));
+			return true;
+		}
+		/**
+		 * the entry at the front, throw container_is_empty if empty() returns true.
+		 */
+		const value_type & front() const
+		{
+			return map_type::front();
+		}
+		void pop_front()
+		{
+			if (this->empty())
+				throw container_is_empty();
+			map_type::erase(map_type::begin());
+		}
+
+		using map_type::size;
+		using map_type::empty;
+		using map_type::clear;
+};
+
+/**
+ * a count-min sketch of 4 rows of saturating 8-bit counters, estimating
+ * how often each key was seen. every row is indexed by a differently
+ * seeded mix of the hash, the estimate is the smallest of the 4 counters.
+ * increments are conservative (only the smallest counters grow), and
+ * once the number of increments reaches the sample size all counters
+ * are halved, so old popularity fades.
+ */
+template<class Key, class Hash = std::hash<Key>>
+class count_min_sketch {
+	private:
+		static const int DEPTH = 4;
+		static const unsigned char MAX_COUNT = 15;
+
+		unsigned char *table;
+		size_t width, additions, sample;
+		Hash hash;
+
+		static size_t mix(size_t h, int row)
+		{
+			unsigned long long x = h + (row + 1) * 0x9e3779b97f4a7c15ULL;
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdULL;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ULL;
+			x ^= x >> 33;
+			return (size_t)x;
+		}
+
+		unsigned char & counter(size_t h, int row) const
+		{
+			return table[row * width + (mix(h, row) & (width - 1))];
+		}
+
+		void age()
+		{
+			for (size_t i = 0; i < DEPTH * width; ++i)
+				table[i] >>= 1;
+			additions /= 2;
+		}
+
+	public:
+		/**
+		 * a sketch sized for about expected distinct keys of interest.
+		 */
+		explicit count_min_sketch(size_t expected): width(16), additions(0)
+		{
+			while (width < expected) width *= 2;
+			sample = 10 * (expected ? expected : 1);
+			table = (unsigned char *) calloc(DEPTH * width, 1);
+		}
+		count_min_sketch(const count_min_sketch &other) = delete;
+		count_min_sketch &operator=(const count_min_sketch &other) = delete;
+		~count_min_sketch()
+		{
+			free(table);
+		}
+
+		void increment(const Key &key)
+		{
+			size_t h = hash(key);
+			unsigned char least = estimate_hash(h);
+			if (least < MAX_COUNT)
+				for (int row = 0; row < DEPTH; ++row)
+					if (counter(h, row) == least) ++counter(h, row);
+			if (++additions >= sample) age();
+		}
+		unsigned char estimate(const Key &key) const
+		{
+			return estimate_hash(hash(key));
+		}
+		unsigned char estimate_hash(size_t h) const
+		{
+			unsigned char least = MAX_COUNT;
+			for (int row = 0; row < DEPTH; ++row)
+				if (counter(h, row) < least) least = counter(h, row);
+			return least;
+		}
+};
+
+/**
+ * the full 2Q of Johnson and Shasha. a new key enters a1in, a FIFO of
+ * a quarter of the capacity, whose hits do not promote it. a key pushed
+ * out of a1in leaves its key behind in the ghost queue a1out (half the
+ * capacity), and only a key seen again while its ghost is there enters
+ * am, the LRU holding the rest of the capacity. a scan therefore only
+ * ever flushes a1in.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class two_queue_cache {
+	private:
+		cache_queue<Key, T, Hash, Equal> a1in, am;
+		cache_queue<Key, bool, Hash, Equal> a1out;
+		size_t max_entries, kin, kout;
+		cache_stats counter;
+
+		// make room for one more resident entry
+		void reclaim()
+		{
+			if (a1in.size() + am.size() < max_entries) return;
+			if (a1in.size() > kin || am.empty()) {
+				a1out.push_back(a1in.front().first, true);
+				a1in.pop_front();
+				if (a1out.size() > kout) a1out.pop_front();
+			}
+			else am.pop_front();
+		}
+
+	public:
+		explicit two_queue_cache(size_t capacity):
+			max_entries(capacity ? capacity : 1), kin(max_entries / 4 ? max_entries / 4 : 1), kout(max_entries / 2 ? max_entries / 2 : 1) {}
+
+		/**
+		 * the cached value of key, nullptr on a miss.
+		 */
+		const T * get(const Key &key)
+		{
+			T *v = am.touch(key);
+			if (!v) v = a1in.find(key);
+			if (v) ++counter.hits;
+			else ++counter.misses;
+			return v;
+		}
+		/**
+		 * cache value under key. return true if key was not cached before.
+		 */
+		bool put(const Key &key, const T &value)
+		{
+			T *v = am.touch(key);
+			if (!v) v = a1in.find(key);
+			if (v) {
+				*v = value;
+				return false;
+			}
+			// look the ghost up first, reclaim() may push it out of a1out
+			bool seen = a1out.erase(key);
+			reclaim();
+			if (seen) am.push_back(key, value);
+			else a1in.push_back(key, value);
+			return true;
+		}
+		bool erase(const Key &key)
+		{
+			return am.erase(key) || a1in.erase(key);
+		}
+
+		size_t size() const {return a1in.size() + am.size();}
+		bool empty() const {return !size();}
+		size_t capacity() const {return max_entries;}
+		const cache_stats & stats() const {return counter;}
+		void reset_stats() {counter = cache_stats();}
+};
+
+/**
+ * the adaptive replacement cache of Megiddo and Modha. t1 holds keys
+ * seen once recently and t2 keys seen at least twice, both LRU; b1 and
+ * b2 remember the keys evicted from each. a miss whose key is in b1
+ * grows the target size p of t1, one in b2 shrinks it, so the split
+ * between recency and frequency follows the workload. keys touched
+ * once by a scan only pass through t1.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class arc_cache {
+	private:
+		cache_queue<Key, T, Hash, Equal> t1, t2;
+		cache_queue<Key, bool, Hash, Equal> b1, b2;
+		size_t max_entries, p;
+		cache_stats counter;
+
+		// evict the lru of t1 or t2 into its ghost list
+		void replace(bool in_b2)
+		{
+			if (!t1.empty() && (t1.size() > p || (in_b2 && t1.size() == p) || t2.empty())) {
+				b1.push_back(t1.front().first, true);
+				t1.pop_front();
+			}
+			else {
+				b2.push_back(t2.front().first, true);
+				t2.pop_front();
+			}
+		}
+
+		bool full() const {return t1.size() + t2.size() >= max_entries;}
+
+		// a resident key was used again, it belongs to t2 now
+		T * promote(const Key &key)
+		{
+			T *v = t2.touch(key);
+			if (v) return v;
+			v = t1.find(key);
+			if (!v) return nullptr;
+			T *w = t2.push_back(key, *v);
+			t1.erase(key);
+			return w;
+		}
+
+	public:
+		explicit arc_cache(size_t capacity): max_entries(capacity ? capacity : 1), p(0) {}
+
+		/**
+		 * the cached value of key, nullptr on a miss.
+		 */
+		const T * get(const Key &key)
+		{
+			T *v = promote(key);
+			if (v) ++counter.hits;
+			else ++counter.misses;
+			return v;
+		}
+		/**
+		 * cache value under key. return true if key was not cached before.
+		 */
+		bool put(const Key &key, const T &value)
+		{
+			T *v = promote(key);
+			if (v) {
+				*v = value;
+				return false;
+			}
+			if (b1.find(key)) {
+				size_t delta = b2.size() > b1.size() ? b2.size() / b1.size() : 1;
+				p = p + delta < max_entries ? p + delta : max_entries;
+				if (full()) replace(false);
+				b1.erase(key);
+				t2.push_back(key, value);
+				return true;
+			}
+			if (b2.find(key)) {
+				size_t delta = b1.size() > b2.size() ? b1.size() / b2.size() : 1;
+				p = p > delta ? p - delta : 0;
+				if (full()) replace(true);
+				b2.erase(key);
+				t2.push_back(key, value);
+				return true;
+			}
+			if (t1.size() + b1.size() >= max_entries) {
+				if (t1.size() < max_entries) {
+					b1.pop_front();
+					if (full()) replace(false);
+				}
+				else t1.pop_front();
+			}
+			else if (full()) {
+				if (t1.size() + t2.size() + b1.size() + b2.size() >= 2 * max_entries) b2.pop_front();
+				replace(false);
+			}
+			t1.push_back(key, value);
+			return true;
+		}
+		bool erase(const Key &key)
+		{
+			return t1.erase(key) || t2.erase(key);
+		}
+
+		size_t size() const {return t1.size() + t2.size();}
+		bool empty() const {return !size();}
+		size_t capacity() const {return max_entries;}
+		const cache_stats & stats() const {return counter;}
+		void reset_stats() {counter = cache_stats();}
+};
+
+/**
+ * W-TinyLFU of Einziger, Friedman and Manes. a small LRU window (1% of
+ * the capacity) takes every new key; the key it pushes out competes with
+ * the victim of the main cache, a segmented LRU of probation (20%) and
+ * protected (80%) entries, and is admitted only if a count-min sketch
+ * of recent accesses says it is more popular. a scan of keys seen once
+ * never beats an entry that has been used, so it only flushes the window.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class tinylfu_cache {
+	private:
+		cache_queue<Key, T, Hash, Equal> window, probation, protect;
+		count_min_sketch<Key, Hash> sketch;
+		size_t max_entries, max_window, max_protect;
+		cache_stats counter;
+
+		// a main cache hit on probation moves to protected, whose lru falls back to probation
+		T * promote(const Key &key)
+		{
+			T *v = protect.touch(key);
+			if (v) return v;
+			if (!max_protect) return probation.touch(key);
+			v = probation.find(key);
+			if (!v) return nullptr;
+			T *w = protect.push_back(key, *v);
+			probation.erase(key);
+			if (protect.size() > max_protect) {
+				probation.push_back(protect.front().first, protect.front().second);
+				protect.pop_front();
+			}
+			return w;
+		}
+
+		T * access(const Key &key)
+		{
+			sketch.increment(key);
+			T *v = window.touch(key);
+			return v ? v : promote(key);
+		}
+
+		// the window is over its size, let its lru compete for the main cache
+		void admit()
+		{
+			const Key &candidate = window.front().first;
+			if (probation.size() + protect.size() + max_window < max_entries)
+				probation.push_back(candidate, window.front().second);
+			else {
+				cache_queue<Key, T, Hash, Equal> &victims = probation.empty() ? protect : probation;
+				if (!victims.empty() && sketch.estimate(candidate) > sketch.estimate(victims.front().first)) {
+					victims.pop_front();
+					probation.push_back(candidate, window.front().second);
+				}
+			}
+			window.pop_front();
+		}
+
+	public:
+		explicit tinylfu_cache(size_t capacity): sketch(capacity), max_entries(capacity ? capacity : 1)
+		{
+			max_window = max_entries / 100 ? max_entries / 100 : 1;
+			max_protect = (max_entries - max_window) * 4 / 5;
+		}
+
+		/**
+		 * the cached value of key, nullptr on a miss.
+		 */
+		const T * get(const Key &key)
+		{
+			T *v = access(key);
+			if (v) ++counter.hits;
+			else ++counter.misses;
+			return v;
+		}
+		/**
+		 * cache value under key. return true if key was not cached before.
+		 */
+		bool put(const Key &key, const T &value)
+		{
+			T *v = access(key);
+			if (v) {
+				*v = value;
+				return false;
+			}
+			window.push_back(key, value);
+			if (window.size() > max_window || size() > max_entries) admit();
+			return true;
+		}
+		bool erase(const Key &key)
+		{
+			return window.erase(key) || probation.erase(key) || protect.erase(key);
+		}
+
+		size_t size() const {return window.size() + probation.size() + protect.size();}
+		bool empty() const {return !size();}
+		size_t capacity() const {return max_entries;}
+		const cache_stats & stats() const {return counter;}
+		void reset_stats() {counter = cache_stats();}
+};
+
+}
+
+#endif
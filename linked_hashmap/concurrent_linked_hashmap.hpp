@@ -0,0 +1,530 @@
+/**
+ * a linked_hashmap for many threads, split into independently locked shards
+ */
+#ifndef SJTU_CONCURRENT_LINKEDHASHMAP_HPP
+#define SJTU_CONCURRENT_LINKEDHASHMAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+
+/**
+ * epoch based reclamation, one domain for every concurrent_linked_hashmap.
+ *
+ * a reader publishes the global epoch in a record owned by its thread
+ * before it loads any pointer into a map, and clears it afterwards; no
+ * other thread writes that record's cache line. memory a writer has
+ * unlinked is retired with the epoch of the moment, and may be freed
+ * once the global epoch is two ahead of it: the epoch only advances
+ * when every reader inside is in the current one, so by then all
+ * readers which could have reached the memory have left.
+ *
+ * records of exited threads are reused by new ones and never freed.
+ */
+class epoch_domain {
+	private:
+		struct alignas(64) record {
+			// 0 outside, otherwise the epoch the thread entered in
+			std::atomic<unsigned long long> local;
+			std::atomic<bool> used;
+			record *next;
+
+			record(): local(0), used(true), next(nullptr) {}
+		};
+
+		// the record of the calling thread, handed back when the thread exits
+		struct owner {
+			record *r;
+
+			owner(): r(instance()._acquire()) {}
+			~owner() {r->used.store(false, std::memory_order_release);}
+		};
+
+		std::atomic<unsigned long long> global;
+		std::atomic<record *> records;
+
+		epoch_domain(): global(1), records(nullptr) {}
+
+		record *_acquire()
+		{
+			for (record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+				bool expected = false;
+				if (!r->used.load(std::memory_order_relaxed) && r->used.compare_exchange_strong(expected, true))
+					return r;
+			}
+			// padded by hand, new only honours alignas(64) from c++17 on. never freed
+			size_t raw = (size_t) malloc(sizeof(record) + alignof(record) - 1);
+			record *r = new((void *) ((raw + alignof(record) - 1) / alignof(record) * alignof(record))) record;
+			r->next = records.load(std::memory_order_relaxed);
+			while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed));
+			return r;
+		}
+
+		static record *_mine()
+		{
+			static thread_local owner o;
+			return o.r;
+		}
+
+	public:
+		static epoch_domain & instance()
+		{
+			static epoch_domain domain;
+			return domain;
+		}
+
+		/**
+		 * keeps memory retired from now on alive while it exists, not reentrant.
+		 */
+		class guard {
+			private:
+				record *r;
+
+			public:
+				guard(): r(_mine())
+				{
+					// release, so a writer which sees this epoch also sees the end of the last guard of the thread
+					r->local.store(instance().global.load(std::memory_order_relaxed), std::memory_order_release);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+				}
+				~guard() {r->local.store(0, std::memory_order_release);}
+				guard(const guard &other) = delete;
+				guard &operator=(const guard &other) = delete;
+		};
+
+		/**
+		 * the epoch to retire memory in, call it after the memory is unlinked.
+		 */
+		unsigned long long retire_epoch()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			return global.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * advance the global epoch if every reader is in it, and return it.
+		 * memory retired in epoch e can be freed once e + 2 is not above it.
+		 */
+		unsigned long long advance()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			unsigned long long e = global.load(std::memory_order_relaxed);
+			// acquire pairs with the stores of guard, so whatever the readers did
+			// before leaving happens before the caller frees memory
+			for (record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+				unsigned long long l = r->local.load(std::memory_order_acquire);
+				if (l != 0 && l != e) return e;
+			}
+			if (global.compare_exchange_strong(e, e + 1)) return e + 1;
+			// e now holds the epoch another writer advanced to
+			return e;
+		}
+};
+
+/**
+ * keys are partitioned into a power-of-two number of shards by the top
+ * bits of their mixed hash, every shard is an ordinary linked_hashmap
+ * on cache lines of its own. insertion order is kept per shard.
+ *
+ * writers of a shard take its mutex, readers take nothing. find() and
+ * count() walk the hash chains while writers may be changing them and
+ * check a sequence counter of the shard afterwards, retrying if a
+ * writer was inside meanwhile; the only store a reader makes is to its
+ * epoch_domain record. so that nothing a reader may still be walking is
+ * freed under it, erased nodes and outgrown tables are retired through
+ * epoch_domain.
+ *
+ * the key, hash and value of a node never change once it is reachable,
+ * upsert() links a new node in place of the old one. its chain links do:
+ * erase() bypasses the node and growing the table threads every node
+ * into a new chain. every store to a bucket or to hash_nex is therefore
+ * an atomic release store and readers load them atomically; a reader
+ * which followed a link being changed fails the sequence check. the
+ * incremental rehash of linked_hashmap is not used, a shard grows its
+ * table at once under its mutex.
+ *
+ * values are handed out by copy or inside a callback which runs under
+ * the lock of the shard, never as a reference which could outlive it.
+ * the callbacks must not call back into the map.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class IndexPolicy = prime_mod_policy>
+class concurrent_linked_hashmap {
+	public:
+		using map_type = linked_hashmap<Key, T, Hash, Equal, IndexPolicy>;
+		using value_type = typename map_type::value_type;
+
+		static const size_t DEFAULT_SHARDS = 64;
+
+	private:
+		using hash_node = typename map_type::hash_node;
+
+		// memory waiting for the readers which might still see it
+		struct retired {
+			void *ptr;
+			void (*drop)(void *);
+			unsigned long long epoch;
+		};
+
+		// garbage a shard keeps before it tries to free some
+		static const size_t COLLECT_AT = 64;
+
+		struct alignas(64) shard : map_type {
+			// odd while a writer is changing the shard
+			std::atomic<unsigned> seq;
+			// the table as readers see it, grown tables are published before their capacity
+			std::atomic<hash_node **> table;
+			std::atomic<size_t> buckets;
+			alignas(64) std::mutex lock;
+			std::vector<retired> garbage;
+			size_t collect_at;
+
+			using map_type::_find;
+
+			// readers index the table without checking for it, so a shard has one from the start
+			shard(): seq(0), table(nullptr), buckets(0), collect_at(COLLECT_AT)
+			{
+				this->_new_hashmap();
+				_publish();
+			}
+			~shard()
+			{
+				for (size_t i = 0; i < garbage.size(); ++i)
+					garbage[i].drop(garbage[i].ptr);
+			}
+
+			static void _drop_node(void *p) {delete (hash_node *)p;}
+			static void _drop_table(void *p) {free(p);}
+
+			static hash_node *_load(hash_node *const *p) {return __atomic_load_n(p, __ATOMIC_ACQUIRE);}
+			static void _store(hash_node **p, hash_node *q) {__atomic_store_n(p, q, __ATOMIC_RELEASE);}
+
+			/**
+			 * whether key with hash h exists, copying its value into out unless
+			 * out is nullptr. call it inside an epoch_domain::guard, without the lock.
+			 */
+			bool read(const Key &key, size_t h, T *out) const
+			{
+				for (;;) {
+					unsigned v = seq.load(std::memory_order_acquire);
+					if (v & 1) {
+						std::this_thread::yield();
+						continue;
+					}
+					size_t n = buckets.load(std::memory_order_acquire);
+					hash_node *p = _load(&table.load(std::memory_order_acquire)[IndexPolicy::index(h, n)]);
+					while (p != nullptr && (p->hash_code != h || !this->equal(p->data.first, key)))
+						p = _load(&p->hash_nex);
+					if (p != nullptr && out != nullptr)
+						*out = p->data.second;
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (seq.load(std::memory_order_relaxed) == v)
+						return p != nullptr;
+				}
+			}
+
+			// the rest is for writers holding the lock
+			void begin()
+			{
+				seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+			}
+			void end()
+			{
+				seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+
+			void _retire(void *ptr, void (*drop)(void *))
+			{
+				garbage.push_back(retired{ptr, drop, epoch_domain::instance().retire_epoch()});
+			}
+
+			// free what no reader can reach any more, once enough has piled up
+			void collect()
+			{
+				if (garbage.size() < collect_at) return;
+				unsigned long long e = epoch_domain::instance().advance();
+				size_t kept = 0;
+				for (size_t i = 0; i < garbage.size(); ++i) {
+					if (garbage[i].epoch + 2 <= e) garbage[i].drop(garbage[i].ptr);
+					else garbage[kept++] = garbage[i];
+				}
+				garbage.resize(kept);
+				// while a slow reader holds the epoch back, do not rescan on every write
+				collect_at = kept * 2 > COLLECT_AT ? kept * 2 : COLLECT_AT;
+			}
+
+			void _publish()
+			{
+				table.store(this->hashmap, std::memory_order_release);
+				buckets.store(this->capacity, std::memory_order_release);
+			}
+
+			// the chain operations of linked_hashmap, with the stores readers may see made atomic.
+			// hash_pre is only read by writers
+			static void _link_hash(hash_node **bucket, hash_node *p)
+			{
+				hash_node *first = *bucket;
+				_store(&p->hash_nex, first);
+				if (first != nullptr)
+					first->hash_pre = &p->hash_nex;
+				p->hash_pre = bucket;
+				_store(bucket, p);
+			}
+			static void _unlink_hash(hash_node *p)
+			{
+				_store(p->hash_pre, p->hash_nex);
+				if (p->hash_nex != nullptr)
+					p->hash_nex->hash_pre = p->hash_pre;
+			}
+			void _rehash()
+			{
+				this->_new_hashmap();
+				for (hash_node *p = this->head->nex; p != this->tail; p = p->nex)
+					_link_hash(&this->hashmap[IndexPolicy::index(p->hash_code, this->capacity)], p);
+			}
+
+			void _grow()
+			{
+				hash_node **old = this->hashmap;
+				this->capacity = IndexPolicy::grow(this->capacity);
+				_rehash();
+				_publish();
+				_retire(old, _drop_table);
+			}
+
+			// key must not exist
+			void add(const value_type &value, size_t h)
+			{
+				if (this->len * 100 > this->capacity * this->loadPercent)
+					_grow();
+				hash_node *p = new hash_node(value);
+				p->hash_code = h;
+				this->privateinsert(this->tail, p);
+				_link_hash(&this->hashmap[IndexPolicy::index(h, this->capacity)], p);
+			}
+
+			void remove(hash_node *p)
+			{
+				_unlink_hash(p);
+				this->privateerase(p);
+				_retire(p, _drop_node);
+			}
+
+			// put q where p is, in its chain and in the list
+			void replace(hash_node *p, hash_node *q)
+			{
+				q->hash_code = p->hash_code;
+				q->hash_nex = p->hash_nex;
+				q->hash_pre = p->hash_pre;
+				if (q->hash_nex != nullptr)
+					q->hash_nex->hash_pre = &q->hash_nex;
+				this->privateinsert(p->nex, q);
+				_store(q->hash_pre, q);
+				this->privateerase(p);
+				_retire(p, _drop_node);
+			}
+
+			// a clear table of the same capacity, nodes and old table retired
+			void wipe()
+			{
+				hash_node **old = this->hashmap;
+				this->_new_hashmap();
+				_publish();
+				for (hash_node *p = this->head->nex; p != this->tail; ) {
+					hash_node *q = p;
+					p = p->nex;
+					_retire(q, _drop_node);
+				}
+				this->head->nex = this->tail;
+				this->tail->pre = this->head;
+				this->len = 0;
+				_retire(old, _drop_table);
+			}
+		};
+
+		shard *shards;
+		// the block shards sits in, new[] only honours alignas(64) from c++17 on
+		void *raw;
+		size_t shardNum;
+		// 64 - log2(shardNum), the top bits of the mixed hash pick the shard
+		int shift;
+		Hash hash;
+
+		// the top bits of the murmur3 finalizer. no IndexPolicy reads them: the
+		// policies take the hash modulo an odd capacity, the top bits of the
+		// fibonacci product or the low bits of the finalizer, so the keys of a
+		// shard still spread over all of its buckets
+		shard & shardOf(size_t h) const
+		{
+			if (shardNum == 1) return shards[0];
+			unsigned long long x = h;
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdULL;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ULL;
+			x ^= x >> 33;
+			return shards[(size_t)(x >> shift)];
+		}
+
+	public:
+		/**
+		 * a map of at least the given number of shards, rounded up to a power of two.
+		 */
+		explicit concurrent_linked_hashmap(size_t _shards = DEFAULT_SHARDS): shardNum(1), shift(64)
+		{
+			while (shardNum < _shards) shardNum *= 2, --shift;
+			raw = malloc(shardNum * sizeof(shard) + alignof(shard) - 1);
+			shards = (shard *) (((size_t) raw + alignof(shard) - 1) / alignof(shard) * alignof(shard));
+			for (size_t i = 0; i < shardNum; ++i)
+				new(shards + i) shard();
+		}
+		concurrent_linked_hashmap(const concurrent_linked_hashmap &other) = delete;
+		concurrent_linked_hashmap &operator=(const concurrent_linked_hashmap &other) = delete;
+		~concurrent_linked_hashmap()
+		{
+			for (size_t i = 0; i < shardNum; ++i)
+				shards[i].~shard();
+			free(raw);
+		}
+
+		/**
+		 * copy the value of key into out. return false if key does not exist.
+		 */
+		bool find(const Key &key, T &out) const
+		{
+			size_t h = hash(key);
+			epoch_domain::guard g;
+			return shardOf(h).read(key, h, &out);
+		}
+		size_t count(const Key &key) const
+		{
+			size_t h = hash(key);
+			epoch_domain::guard g;
+			return shardOf(h).read(key, h, nullptr) ? 1 : 0;
+		}
+
+		/**
+		 * insert key with value unless it exists. return whether the insertion took place.
+		 */
+		bool insert(const Key &key, const T &value)
+		{
+			size_t h = hash(key);
+			shard &s = shardOf(h);
+			std::lock_guard<std::mutex> guard(s.lock);
+			if (s._find(key) != nullptr) return false;
+			s.begin();
+			s.add(value_type(key, value), h);
+			s.end();
+			s.collect();
+			return true;
+		}
+
+		/**
+		 * insert key with value if it does not exist, otherwise call f(value)
+		 * on a copy of the existing value under the lock of its shard, and
+		 * store the copy. return true if key was inserted.
+		 */
+		template<class F>
+		bool upsert(const Key &key, const T &value, F f)
+		{
+			size_t h = hash(key);
+			shard &s = shardOf(h);
+			std::lock_guard<std::mutex> guard(s.lock);
+			hash_node *p = s._find(key);
+			if (p == nullptr) {
+				s.begin();
+				s.add(value_type(key, value), h);
+				s.end();
+				s.collect();
+				return true;
+			}
+			T updated(p->data.second);
+			f(updated);
+			hash_node *q = new hash_node(value_type(p->data.first, std::move(updated)));
+			s.begin();
+			s.replace(p, q);
+			s.end();
+			s.collect();
+			return false;
+		}
+
+		/**
+		 * erase key. return false if it does not exist.
+		 */
+		bool erase(const Key &key)
+		{
+			shard &s = shardOf(hash(key));
+			std::lock_guard<std::mutex> guard(s.lock);
+			hash_node *p = s._find(key);
+			if (p == nullptr) return false;
+			s.begin();
+			s.remove(p);
+			s.end();
+			s.collect();
+			return true;
+		}
+
+		/**
+		 * call f(shard index, const map_type &) for every shard under its
+		 * lock, with up to threads threads taking shards one at a time, so f
+		 * may run on several threads at once. every shard is visited in its
+		 * insertion order.
+		 */
+		template<class F>
+		void for_each_shard(F f, size_t threads = std::thread::hardware_concurrency()) const
+		{
+			std::atomic<size_t> next(0);
+			auto worker = [&]() {
+				for (size_t i; (i = next.fetch_add(1)) < shardNum; ) {
+					std::lock_guard<std::mutex> guard(shards[i].lock);
+					f(i, (const map_type &)shards[i]);
+				}
+			};
+			if (threads > shardNum) threads = shardNum;
+			std::vector<std::thread> workers;
+			for (size_t t = 1; t < threads; ++t) workers.emplace_back(worker);
+			worker();
+			for (auto &w : workers) w.join();
+		}
+
+		/**
+		 * the number of elements, exact only when no other thread is modifying the map.
+		 */
+		size_t size() const
+		{
+			size_t ret = 0;
+			for (size_t i = 0; i < shardNum; ++i) {
+				std::lock_guard<std::mutex> guard(shards[i].lock);
+				ret += shards[i].size();
+			}
+			return ret;
+		}
+		bool empty() const {return !size();}
+		void clear()
+		{
+			for (size_t i = 0; i < shardNum; ++i) {
+				std::lock_guard<std::mutex> guard(shards[i].lock);
+				shards[i].begin();
+				shards[i].wipe();
+				shards[i].end();
+				shards[i].collect();
+			}
+		}
+		size_t shard_count() const {return shardNum;}
+};
+
+}
+
+#endif
@@ -0,0 +1,149 @@
+#include "lru_cache.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// an entry weighs its value modulo 10, plus one
+struct weigher {
+	size_t operator()(const int &, const int &value) const {return value % 10 + 1;}
+};
+
+typedef sjtu::lru_cache<int, int, std::hash<int>, std::equal_to<int>, weigher> cache;
+
+// an lru cache on std::map: the values, and the keys by the time of their last use
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> recency;
+	std::map<int, long long> used;
+	long long clock;
+	size_t maxSize, maxBytes, bytes;
+	std::vector<int> evicted;
+
+	reference(size_t _maxSize, size_t _maxBytes): clock(0), maxSize(_maxSize), maxBytes(_maxBytes), bytes(0) {}
+	void touch(int key)
+	{
+		if (used.count(key)) recency.erase(used[key]);
+		recency[clock] = key;
+		used[key] = clock++;
+	}
+	void remove(int key)
+	{
+		bytes -= values[key] % 10 + 1;
+		recency.erase(used[key]);
+		used.erase(key);
+		values.erase(key);
+	}
+	void evict()
+	{
+		while (!values.empty() && ((maxSize && values.size() > maxSize) || (maxBytes && bytes > maxBytes))) {
+			int key = recency.begin()->second;
+			evicted.push_back(key);
+			remove(key);
+		}
+	}
+	bool put(int key, int value)
+	{
+		bool inserted = !values.count(key);
+		if (!inserted) bytes -= values[key] % 10 + 1;
+		values[key] = value;
+		bytes += value % 10 + 1;
+		touch(key);
+		evict();
+		return inserted;
+	}
+};
+
+bool same(const cache &c, const reference &r)
+{
+	if (c.size() != r.values.size() || c.bytes() != r.bytes) return false;
+	cache::const_iterator it = c.cbegin();
+	for (std::map<long long, int>::const_iterator o = r.recency.begin(); o != r.recency.end(); ++o, ++it)
+		if (it == c.cend() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+	return it == c.cend();
+}
+
+bool check(size_t maxSize, size_t maxBytes)
+{
+	cache c(maxSize, maxBytes);
+	reference r(maxSize, maxBytes);
+	std::vector<int> evicted;
+	c.set_eviction_callback([&evicted](const int &key, const int &) {evicted.push_back(key);});
+	size_t hits = 0, misses = 0;
+	for (int i = 0; i < 200000; ++i) {
+		int key = nextRand() % 400, op = nextRand() % 10;
+		if (op < 4) {
+			int value = nextRand() % 1000;
+			if (c.put(key, value) != r.put(key, value)) return false;
+		}
+		else if (op < 7) {
+			const int *v = c.get(key);
+			if ((v != nullptr) != (r.values.count(key) > 0)) return false;
+			if (v) {
+				if (*v != r.values[key]) return false;
+				r.touch(key);
+				++hits;
+			}
+			else ++misses;
+		}
+		else if (op < 8) {
+			const int *v = c.peek(key);
+			if ((v != nullptr) != (r.values.count(key) > 0) || (v && *v != r.values[key])) return false;
+			if (c.count(key) != r.values.count(key)) return false;
+		}
+		else if (op < 9) {
+			bool cached = r.values.count(key);
+			if (c.erase(key) != cached) return false;
+			if (cached) r.remove(key);
+		}
+		else if (i % 1000 == 0) {
+			// shrink to half, then back
+			c.set_capacity(maxSize / 2, maxBytes / 2);
+			r.maxSize = maxSize / 2;
+			r.maxBytes = maxBytes / 2;
+			r.evict();
+			if (!same(c, r)) return false;
+			c.set_capacity(maxSize, maxBytes);
+			r.maxSize = maxSize;
+			r.maxBytes = maxBytes;
+		}
+		if (evicted != r.evicted) return false;
+		evicted.clear();
+		r.evicted.clear();
+		if (i % 1000 == 0 && !same(c, r)) return false;
+	}
+	if (c.stats().hits != hits || c.stats().misses != misses) return false;
+	c.clear();
+	return c.empty() && c.bytes() == 0;
+}
+
+bool checkStrings()
+{
+	sjtu::lru_cache<std::string, std::string> c(3);
+	c.put("a", "1");
+	c.put("b", "2");
+	c.put("c", "3");
+	c.get("a");
+	c.put("d", "4");
+	// b was the least recently used
+	return !c.peek("b") && *c.peek("a") == "1" && c.size() == 3 && c.cbegin()->first == "c";
+}
+
+int main()
+{
+	if (!check(100, 0)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check(0, 700)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check(150, 500)) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check(1, 0)) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!checkStrings()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	return 0;
+}
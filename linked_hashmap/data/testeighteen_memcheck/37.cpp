@@ -0,0 +1,215 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+template<class Map>
+bool same(Map &m, const reference &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	typename Map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || m.at(o->second) != r.values.find(o->second)->second) return false;
+	}
+	return it == m.end();
+}
+
+// a map grows once its load is over max_load_factor, so one insert may leave it a bucket over;
+// up to eight elements there are no buckets at all
+template<class Map>
+bool underMaxLoad(const Map &m)
+{
+	if (m.bucket_count() == 0) return m.size() <= 8;
+	return m.size() * 100 <= m.bucket_count() * (size_t)(m.max_load_factor() * 100 + 0.5f) + 100;
+}
+
+// after reserve(n), n elements go in without the table changing
+template<class Policy>
+bool check1()
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	const size_t sizes[5] = {9, 100, 1000, 5000, 10000};
+	for (int s = 0; s < 5; ++s) {
+		map m;
+		m.reserve(sizes[s]);
+		size_t buckets = m.bucket_count();
+		if (buckets * m.max_load_factor() < sizes[s]) return false;
+		for (size_t i = 0; i < sizes[s]; ++i) {
+			m[(int)nextRand()] = 0;
+			if (m.bucket_count() != buckets) return false;
+		}
+		// reserving less than the size is a no-op
+		m.reserve(1);
+		if (m.bucket_count() != buckets) return false;
+	}
+	return true;
+}
+
+// max_load_factor bounds the load through growth and rehashes at once when lowered
+template<class Policy>
+bool check2()
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	const float factors[5] = {0.25f, 0.5f, 1.0f, 2.0f, 4.0f};
+	for (int f = 0; f < 5; ++f) {
+		map m;
+		reference r;
+		m.max_load_factor(factors[f]);
+		if (m.max_load_factor() != factors[f]) return false;
+		for (int i = 0; i < 5000; ++i) {
+			int key = nextRand() % 100000;
+			if (r.values.count(key)) continue;
+			m[key] = i;
+			r.insert(key, i);
+			if (!underMaxLoad(m)) return false;
+		}
+		m.max_load_factor(factors[f] / 4);
+		if (m.load_factor() > m.max_load_factor() || !same(m, r)) return false;
+	}
+	map m;
+	int thrown = 0;
+	try {m.max_load_factor(0);} catch (sjtu::runtime_error &) {++thrown;}
+	try {m.max_load_factor(-1);} catch (sjtu::runtime_error &) {++thrown;}
+	return thrown == 2 && m.max_load_factor() == 0.75f;
+}
+
+// rehash(b) gives at least b buckets, rehash(0) the fewest that fit; order and contents stay
+template<class Policy>
+bool check3()
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	map m;
+	reference r;
+	for (int i = 0; i < 10000; ++i) {
+		int key = nextRand() % 1000000, op = nextRand() % 10;
+		bool exists = r.values.count(key);
+		if (op < 6) {
+			if (exists) continue;
+			m[key] = i;
+			r.insert(key, i);
+		}
+		else if (op < 9) {
+			if (!exists) continue;
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		else if (nextRand() % 300 == 0) {
+			size_t b = nextRand() % 200000;
+			m.rehash(b);
+			if (m.bucket_count() < b || !underMaxLoad(m) || !same(m, r)) return false;
+		}
+	}
+	for (int k = 0; k < 3000 && !r.values.empty(); ++k) {
+		int key = r.values.begin()->first;
+		m.erase(m.find(key));
+		r.erase(key);
+	}
+	size_t before = m.bucket_count();
+	m.rehash(0);
+	if (m.bucket_count() >= before || m.load_factor() > m.max_load_factor()) return false;
+	// the table is the fewest buckets which hold the size: one step down would be over the load
+	map fresh;
+	fresh.reserve(m.size());
+	return m.bucket_count() == fresh.bucket_count() && same(m, r);
+}
+
+// with min_load_factor, erases shrink the table and clear() frees it; without, neither happens
+template<class Policy>
+bool check4()
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	map m, keep;
+	reference r;
+	m.min_load_factor(0.1f);
+	if (m.min_load_factor() != 0.1f || keep.min_load_factor() != 0) return false;
+	std::vector<int> keys;
+	for (int i = 0; i < 10000; ++i) {
+		int key = nextRand() % 10000000;
+		if (r.values.count(key)) continue;
+		m[key] = keep[key] = i;
+		r.insert(key, i);
+		keys.push_back(key);
+	}
+	size_t grown = m.bucket_count();
+	if (keep.bucket_count() != grown) return false;
+	while (keys.size() > 500) {
+		size_t k = nextRand() % keys.size();
+		int key = keys[k];
+		keys[k] = keys.back();
+		keys.pop_back();
+		m.erase(m.find(key));
+		keep.erase(keep.find(key));
+		r.erase(key);
+		// the load never falls under a tenth
+		if (m.size() * 10 < m.bucket_count()) return false;
+		if (!underMaxLoad(m)) return false;
+	}
+	if (m.bucket_count() >= grown / 2 || keep.bucket_count() != grown || !same(m, r) || !same(keep, r)) return false;
+	// copies keep both factors
+	map copy(m);
+	if (copy.min_load_factor() != 0.1f || copy.max_load_factor() != m.max_load_factor()) return false;
+	m.clear();
+	keep.clear();
+	if (m.bucket_count() != 0 || keep.bucket_count() != grown) return false;
+	m[1] = 1;
+	return m.size() == 1 && m.at(1) == 1 && same(copy, r);
+}
+
+// min_load_factor over a quarter of max_load_factor acts as a quarter, so a shrunk table
+// has room to grow into
+bool check5()
+{
+	sjtu::linked_hashmap<int, int> m;
+	m.min_load_factor(0.9f);
+	for (int i = 0; i < 5000; ++i) m[i] = i;
+	for (int i = 0; i < 5000; ++i) {
+		m.erase(m.find(i));
+		if (m.size() > 8 && m.load_factor() > m.max_load_factor()) return false;
+	}
+	return m.empty();
+}
+
+int main()
+{
+	if (!check1<sjtu::prime_mod_policy>()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check1<sjtu::pow2_murmur_policy>()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check2<sjtu::prime_mod_policy>()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check2<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!check3<sjtu::prime_mod_policy>()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check3<sjtu::pow2_murmur_policy>()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	if (!check4<sjtu::prime_mod_policy>()) std::cout << "Test 7 Failed......" << std::endl; else std::cout << "Test 7 Passed!" << std::endl;
+	if (!check4<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 8 Failed......" << std::endl; else std::cout << "Test 8 Passed!" << std::endl;
+	if (!check5()) std::cout << "Test 9 Failed......" << std::endl; else std::cout << "Test 9 Passed!" << std::endl;
+	return 0;
+}
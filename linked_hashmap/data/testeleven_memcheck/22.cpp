@@ -0,0 +1,211 @@
+// build: g++ -std=c++17 -O2 -pthread -I../.. 22.cpp -o 22
+#include "concurrent_linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+typedef sjtu::concurrent_linked_hashmap<int, int> cmap;
+typedef sjtu::concurrent_linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pow2_fibonacci_policy> fibonacci_map;
+typedef sjtu::concurrent_linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pow2_murmur_policy> murmur_map;
+
+// the entries over all shards, each shard in its own order, by shard index
+template<class Map>
+std::vector<std::vector<std::pair<int, int>>> contents(const Map &m, size_t threads)
+{
+	std::vector<std::vector<std::pair<int, int>>> ret(m.shard_count());
+	m.for_each_shard([&](size_t i, const typename Map::map_type &s) {
+		for (typename Map::map_type::const_iterator it = s.cbegin(); it != s.cend(); ++it)
+			ret[i].push_back(std::make_pair(it->first, it->second));
+	}, threads);
+	return ret;
+}
+
+// the map holds what values holds, and every shard lists its keys in the
+// order they were inserted, which inserted records
+template<class Map>
+bool same(const Map &m, const std::map<int, int> &values, const std::map<int, long long> &inserted, size_t threads)
+{
+	std::vector<std::vector<std::pair<int, int>>> shards = contents(m, threads);
+	size_t n = 0;
+	for (size_t i = 0; i < shards.size(); ++i)
+		for (size_t j = 0; j < shards[i].size(); ++j) {
+			std::map<int, int>::const_iterator it = values.find(shards[i][j].first);
+			if (it == values.end() || it->second != shards[i][j].second) return false;
+			if (j && inserted.at(shards[i][j - 1].first) > inserted.at(shards[i][j].first)) return false;
+			++n;
+		}
+	return n == values.size() && m.size() == n && m.empty() == !n;
+}
+
+// one thread, every operation against std::map, growing each shard many times
+template<class Map>
+bool check(size_t shardNum, int ops, int keys)
+{
+	Map m(shardNum);
+	if (m.shard_count() < shardNum || (m.shard_count() & (m.shard_count() - 1))) return false;
+	std::map<int, int> values;
+	std::map<int, long long> inserted;
+	for (int i = 0; i < ops; ++i) {
+		int key = nextRand() % keys, op = nextRand() % 100;
+		if (op < 35) {
+			int value = nextRand() % 1000000;
+			bool absent = !values.count(key);
+			if (m.insert(key, value) != absent) return false;
+			if (absent) {
+				values[key] = value;
+				inserted[key] = i;
+			}
+		}
+		else if (op < 55) {
+			int value = nextRand() % 1000000, add = nextRand() % 100;
+			bool absent = !values.count(key);
+			if (m.upsert(key, value, [add](int &v) {v += add;}) != absent) return false;
+			if (absent) {
+				values[key] = value;
+				inserted[key] = i;
+			}
+			else values[key] += add;
+		}
+		else if (op < 70) {
+			if (m.erase(key) != (values.erase(key) == 1)) return false;
+			inserted.erase(key);
+		}
+		else if (op < 85) {
+			int value = -1;
+			bool found = m.find(key, value);
+			if (found != (values.count(key) == 1) || (found && value != values[key])) return false;
+		}
+		else if (op < 99) {
+			if (m.count(key) != values.count(key)) return false;
+		}
+		else if (nextRand() % 20 == 0) {
+			m.clear();
+			values.clear();
+			inserted.clear();
+		}
+		if (i % 1000 == 0 && !same(m, values, inserted, 1)) return false;
+	}
+	return same(m, values, inserted, 4);
+}
+
+// writers on disjoint keys, each checked against its own std::map, and
+// the union against the map at the end
+bool checkThreads(int threadNum, int ops)
+{
+	cmap m(8);
+	std::vector<std::map<int, int>> values(threadNum);
+	std::vector<std::map<int, long long>> inserted(threadNum);
+	std::vector<char> ok(threadNum, 1);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadNum; ++t)
+		threads.emplace_back([&, t]() {
+			unsigned long long s = 19260817 + t;
+			for (int i = 0; i < ops; ++i) {
+				s ^= s << 13;
+				s ^= s >> 7;
+				s ^= s << 17;
+				// thread t owns the keys equal to t modulo threadNum
+				int key = (int)(s % 20000) * threadNum + t, op = (s >> 20) % 10;
+				if (op < 4) {
+					bool absent = !values[t].count(key);
+					if (m.insert(key, i) != absent) ok[t] = 0;
+					if (absent) {
+						values[t][key] = i;
+						inserted[t][key] = i;
+					}
+				}
+				else if (op < 6) {
+					if (m.upsert(key, i, [](int &v) {++v;})) {
+						values[t][key] = i;
+						inserted[t][key] = i;
+					}
+					else ++values[t][key];
+				}
+				else if (op < 8) {
+					if (m.erase(key) != (values[t].erase(key) == 1)) ok[t] = 0;
+					inserted[t].erase(key);
+				}
+				else {
+					int value = -1;
+					bool found = m.find(key, value);
+					if (found != (values[t].count(key) == 1) || (found && value != values[t][key])) ok[t] = 0;
+				}
+			}
+		});
+	for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+	std::map<int, int> all;
+	std::map<int, long long> order;
+	for (int t = 0; t < threadNum; ++t) {
+		if (!ok[t]) return false;
+		all.insert(values[t].begin(), values[t].end());
+	}
+	// the insertion order across threads is unknown, only check the contents
+	for (std::map<int, int>::iterator it = all.begin(); it != all.end(); ++it) order[it->first] = 0;
+	return same(m, all, order, 4);
+}
+
+// sequential keys under an identity hash: the bits which pick the shard
+// must not be the ones the bucket index is taken from, or the keys of a
+// shard pile up in a few of its buckets
+template<class Map, class Policy>
+bool checkSpread(int keys)
+{
+	Map m(64);
+	for (int i = 0; i < keys; ++i) m.insert(i, i);
+	bool ok = true;
+	m.for_each_shard([&](size_t, const typename Map::map_type &s) {
+		std::set<size_t> used;
+		for (typename Map::map_type::const_iterator it = s.cbegin(); it != s.cend(); ++it)
+			used.insert(Policy::index(std::hash<int>()(it->first), s.bucket_count()));
+		// at a load under 0.75, chains average well below 2 keys
+		if (used.size() * 2 < s.size()) ok = false;
+	}, 1);
+	return ok && m.size() == (size_t)keys;
+}
+
+bool checkStringKeys()
+{
+	sjtu::concurrent_linked_hashmap<std::string, std::string> m(2);
+	std::map<std::string, std::string> r;
+	for (int i = 0; i < 2000; ++i) {
+		std::string key = std::to_string(nextRand() % 3000), value = std::to_string(nextRand());
+		if (nextRand() % 3) {
+			if (m.upsert(key, value, [](std::string &v) {v += "!";})) r[key] = value;
+			else r[key] += "!";
+		}
+		else if (m.erase(key) != (r.erase(key) == 1)) return false;
+	}
+	for (std::map<std::string, std::string>::iterator it = r.begin(); it != r.end(); ++it) {
+		std::string value;
+		if (!m.find(it->first, value) || value != it->second) return false;
+	}
+	return m.size() == r.size();
+}
+
+int main()
+{
+	if (!check<cmap>(1, 30000, 5000)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check<cmap>(5, 30000, 50000)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check<cmap>(64, 30000, 100)) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!checkThreads(4, 20000)) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!checkStringKeys()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check<fibonacci_map>(64, 30000, 50000)) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	if (!check<murmur_map>(64, 30000, 50000)) std::cout << "Test 7 Failed......" << std::endl; else std::cout << "Test 7 Passed!" << std::endl;
+	if (!checkSpread<cmap, sjtu::prime_mod_policy>(20000)) std::cout << "Test 8 Failed......" << std::endl; else std::cout << "Test 8 Passed!" << std::endl;
+	if (!checkSpread<fibonacci_map, sjtu::pow2_fibonacci_policy>(20000)) std::cout << "Test 9 Failed......" << std::endl; else std::cout << "Test 9 Passed!" << std::endl;
+	if (!checkSpread<murmur_map, sjtu::pow2_murmur_policy>(20000)) std::cout << "Test 10 Failed......" << std::endl; else std::cout << "Test 10 Passed!" << std::endl;
+	return 0;
+}
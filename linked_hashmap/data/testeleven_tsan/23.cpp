@@ -0,0 +1,67 @@
+// build: g++ -std=c++17 -O1 -g -fsanitize=thread -Wno-tsan -pthread -I../.. 23.cpp -o 23
+// readers racing writers which insert, upsert, erase, clear and grow the
+// shards. besides the answer, ThreadSanitizer must report no data race
+#include "concurrent_linked_hashmap.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef sjtu::concurrent_linked_hashmap<int, std::string> cmap;
+
+// a value starts with its key
+bool belongs(int key, const std::string &value)
+{
+	std::string prefix = std::to_string(key);
+	return value.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool check(int writerNum, int readerNum, int ops)
+{
+	cmap m(4);
+	std::atomic<bool> stop(false), ok(true);
+	std::vector<std::thread> writers, readers;
+	for (int w = 0; w < writerNum; ++w)
+		writers.emplace_back([&, w]() {
+			unsigned x = 7 + w;
+			for (int i = 0; i < ops; ++i) {
+				x = x * 1103515245 + 12345;
+				int key = (x >> 8) % 5000, op = (x >> 4) % 100;
+				if (op < 40) m.insert(key, std::to_string(key));
+				else if (op < 70)
+					m.upsert(key, std::to_string(key), [](std::string &v) {
+						v += "+";
+						if (v.size() > 40) v.resize(10);
+					});
+				else if (op < 99) m.erase(key);
+				else if (i % 5000 == 0) m.clear();
+			}
+		});
+	for (int r = 0; r < readerNum; ++r)
+		readers.emplace_back([&, r]() {
+			unsigned x = 100 + r;
+			std::string value;
+			while (!stop.load()) {
+				x = x * 1103515245 + 12345;
+				int key = (x >> 8) % 5000;
+				if (m.find(key, value) && !belongs(key, value)) ok = false;
+				if (m.count(key) > 1) ok = false;
+			}
+		});
+	for (size_t i = 0; i < writers.size(); ++i) writers[i].join();
+	stop = true;
+	for (size_t i = 0; i < readers.size(); ++i) readers[i].join();
+	// the writers are done, every value left must still be intact
+	for (int key = 0; key < 5000; ++key) {
+		std::string value;
+		if (m.find(key, value) && !belongs(key, value)) return false;
+	}
+	return ok;
+}
+
+int main()
+{
+	if (!check(2, 3, 200000)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include "linked_hashmap.hpp"
+#include "flat_linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <cstring>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// a key which counts how often one is made; it cannot be made from anything but a std::string
+long long labelsMade = 0;
+struct label {
+	std::string s;
+	explicit label(const std::string &_s): s(_s) {++labelsMade;}
+	label(const label &other): s(other.s) {++labelsMade;}
+};
+// a part of some buffer, not terminated
+struct piece {
+	const char *p;
+	size_t n;
+};
+
+size_t fnv(const char *p, size_t n)
+{
+	size_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < n; ++i) h = (h ^ (unsigned char)p[i]) * 1099511628211ULL;
+	return h;
+}
+// hash and equal for labels, pieces and c strings alike
+struct labelHash {
+	typedef void is_transparent;
+	size_t operator()(const label &l) const {return fnv(l.s.data(), l.s.size());}
+	size_t operator()(const piece &k) const {return fnv(k.p, k.n);}
+	size_t operator()(const char *k) const {return fnv(k, strlen(k));}
+};
+struct labelEqual {
+	typedef void is_transparent;
+	bool operator()(const label &a, const label &b) const {return a.s == b.s;}
+	bool operator()(const label &a, const piece &b) const {return a.s.size() == b.n && a.s.compare(0, b.n, b.p, b.n) == 0;}
+	bool operator()(const label &a, const char *b) const {return a.s == b;}
+};
+// the same without is_transparent
+struct plainHash {
+	size_t operator()(const label &l) const {return fnv(l.s.data(), l.s.size());}
+};
+struct plainEqual {
+	bool operator()(const label &a, const label &b) const {return a.s == b.s;}
+};
+
+// whether m.find(k) compiles for a K
+template<class Map, class K, class = void>
+struct findsBy {static const bool value = false;};
+template<class Map, class K>
+struct findsBy<Map, K, typename sjtu::make_void<decltype(std::declval<Map &>().find(std::declval<const K &>()))>::type> {
+	static const bool value = true;
+};
+
+typedef sjtu::linked_hashmap<label, int, labelHash, labelEqual> map;
+typedef sjtu::flat_linked_hashmap<label, int, labelHash, labelEqual> flatMap;
+
+static_assert(findsBy<map, piece>::value && findsBy<map, const char *>::value, "transparent lookup");
+static_assert(findsBy<flatMap, piece>::value && findsBy<flatMap, const char *>::value, "transparent lookup");
+static_assert(!findsBy<sjtu::linked_hashmap<label, int, plainHash, plainEqual>, piece>::value, "lookup by Key only");
+static_assert(!findsBy<sjtu::flat_linked_hashmap<label, int, plainHash, plainEqual>, piece>::value, "lookup by Key only");
+
+// keys "k0" .. "k9999" laid out one after another in a buffer, a piece of it is one key
+std::string buffer;
+size_t offset[10001];
+
+// insert by label, look up by piece and by c string against std::map; no lookup makes a label
+template<class Map>
+bool check1()
+{
+	Map m;
+	const Map &c = m;
+	std::map<std::string, int> r;
+	for (int i = 0; i < 200000; ++i) {
+		int id = nextRand() % 10000, op = nextRand() % 6;
+		std::string s = "k" + std::to_string(id);
+		piece k = {buffer.data() + offset[id], offset[id + 1] - offset[id]};
+		bool exists = r.count(s);
+		long long made = labelsMade;
+		if (op < 2) {
+			m[label(s)] = i;
+			r[s] = i;
+			continue;
+		}
+		if (op < 3) {
+			typename Map::iterator it = m.find(k);
+			if ((it == m.end()) == exists) return false;
+			if (exists && (it->first.s != s || it->second != r[s])) return false;
+			if (exists && nextRand() % 2) {
+				m.erase(it);
+				r.erase(s);
+				continue;
+			}
+		}
+		else if (op < 4) {
+			typename Map::const_iterator it = c.find(s.c_str());
+			if ((it == c.cend()) == exists) return false;
+			if (exists && it->second != r[s]) return false;
+		}
+		else if (op < 5) {
+			if (m.count(k) != (size_t)exists || c.count(s.c_str()) != (size_t)exists) return false;
+		}
+		else if (exists) {
+			if (m.at(k) != r[s] || c.at(s.c_str()) != r[s]) return false;
+			m.at(k) = -i;
+			r[s] = -i;
+		}
+		else {
+			int thrown = 0;
+			try {m.at(k);} catch (sjtu::index_out_of_bound &) {++thrown;}
+			try {c.at(s.c_str());} catch (sjtu::index_out_of_bound &) {++thrown;}
+			if (thrown != 2) return false;
+		}
+		if (labelsMade != made) return false;
+	}
+	if (m.size() != r.size()) return false;
+	for (std::map<std::string, int>::iterator it = r.begin(); it != r.end(); ++it)
+		if (m.at(it->first.c_str()) != it->second) return false;
+	return true;
+}
+
+// a piece is compared by its length, not up to a terminator
+template<class Map>
+bool check2()
+{
+	Map m;
+	m[label("ab")] = 1;
+	m[label("abc")] = 2;
+	const char *text = "abcd";
+	piece a = {text, 1}, ab = {text, 2}, abc = {text, 3}, abcd = {text, 4};
+	return m.count(a) == 0 && m.at(ab) == 1 && m.at(abc) == 2 && m.find(abcd) == m.end() && m.count("abc") == 1;
+}
+
+int main()
+{
+	for (int id = 0; id < 10000; ++id) {
+		offset[id] = buffer.size();
+		buffer += "k" + std::to_string(id);
+	}
+	offset[10000] = buffer.size();
+	if (!check1<map>()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check1<flatMap>()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check2<map>()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check2<flatMap>()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,173 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// std::hash which counts its calls, and a hash putting every key in one chain
+long long hashCalls = 0;
+struct countingHash {
+	size_t operator()(int x) const {
+		++hashCalls;
+		return std::hash<int>()(x);
+	}
+};
+struct oneHash {
+	size_t operator()(int) const {return 7;}
+};
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+template<class Map>
+bool same(Map &m, const reference &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	typename Map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+	}
+	if (it != m.end()) return false;
+	// every element is still found through its chain
+	for (std::map<int, int>::const_iterator v = r.values.begin(); v != r.values.end(); ++v) {
+		typename Map::iterator f = m.find(v->first);
+		if (f == m.end() || f->second != v->second) return false;
+	}
+	return true;
+}
+
+typedef sjtu::linked_hashmap<int, int, countingHash> map;
+
+// erasing by iterator, at random points of the list and while the table grows, never hashes
+bool check1()
+{
+	map m;
+	reference r;
+	std::vector<int> keys;
+	for (int i = 0; i < 200000; ++i) {
+		int op = nextRand() % 5;
+		if (op < 3) {
+			int key = nextRand() % 1000000;
+			if (r.values.count(key)) continue;
+			m[key] = i;
+			r.insert(key, i);
+			keys.push_back(key);
+		}
+		else if (!keys.empty()) {
+			size_t k = nextRand() % keys.size();
+			int key = keys[k];
+			keys[k] = keys.back();
+			keys.pop_back();
+			map::iterator it = m.find(key);
+			long long before = hashCalls;
+			m.erase(it);
+			if (hashCalls != before) return false;
+			r.erase(key);
+		}
+		if (i % 10000 == 0 && !same(m, r)) return false;
+	}
+	return same(m, r);
+}
+
+// erase every other element in one pass over the list, then the rest from the back
+bool check2()
+{
+	map m;
+	reference r;
+	for (int i = 0; i < 100000; ++i) {
+		int key = nextRand() % 10000000;
+		if (r.values.count(key)) continue;
+		m[key] = i;
+		r.insert(key, i);
+	}
+	bool odd = false;
+	for (map::iterator it = m.begin(); it != m.end(); odd = !odd) {
+		map::iterator next = it;
+		++next;
+		if (odd) {
+			r.erase(it->first);
+			m.erase(it);
+		}
+		it = next;
+	}
+	if (!same(m, r)) return false;
+	while (!m.empty()) {
+		map::iterator last = m.end();
+		--last;
+		r.erase(last->first);
+		m.erase(last);
+		if (m.size() % 1000 == 0 && !same(m, r)) return false;
+	}
+	return r.values.empty() && m.begin() == m.end();
+}
+
+// all keys in one chain, erased from its front, middle and back
+bool check3()
+{
+	sjtu::linked_hashmap<int, int, oneHash> m;
+	reference r;
+	for (int i = 0; i < 3000; ++i) {
+		int key = nextRand() % 5000;
+		if (nextRand() % 3) {
+			if (r.values.count(key)) continue;
+			m[key] = i;
+			r.insert(key, i);
+		}
+		else if (r.values.count(key)) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		if (i % 100 == 0 && !same(m, r)) return false;
+	}
+	return same(m, r);
+}
+
+// bad iterators still throw
+bool check4()
+{
+	map m, other;
+	m[1] = 1;
+	other[1] = 1;
+	int thrown = 0;
+	try {m.erase(m.end());} catch (sjtu::invalid_iterator &) {++thrown;}
+	try {m.erase(other.begin());} catch (sjtu::invalid_iterator &) {++thrown;}
+	m.erase(m.begin());
+	try {m.erase(m.begin());} catch (sjtu::invalid_iterator &) {++thrown;}
+	return thrown == 3 && m.empty() && other.size() == 1;
+}
+
+int main()
+{
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,99 @@
+#include "cache_policy.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// random puts, gets and erases on a skewed key set. every hit must return the
+// value last put under its key, which a std::map remembers, and the cache
+// never holds more than its capacity
+template<class Cache>
+bool checkValues(size_t capacity)
+{
+	Cache c(capacity);
+	std::map<int, int> store;
+	size_t hits = 0, misses = 0;
+	for (int i = 0; i < 30000; ++i) {
+		// half the operations go to a tenth of the keys
+		int key = nextRand() % 2 ? nextRand() % (capacity / 2 + 1) : nextRand() % (capacity * 5);
+		int op = nextRand() % 10;
+		if (op < 4) {
+			int value = nextRand() % 1000000;
+			bool cached = c.get(key) != nullptr;
+			++(cached ? hits : misses);
+			if (c.put(key, value) == cached) return false;
+			store[key] = value;
+			// a key just put is cached
+			const int *v = c.get(key);
+			++hits;
+			if (!v || *v != value) return false;
+		}
+		else if (op < 9) {
+			const int *v = c.get(key);
+			if (v) {
+				++hits;
+				if (!store.count(key) || *v != store[key]) return false;
+			}
+			else ++misses;
+		}
+		else {
+			bool cached = c.get(key) != nullptr;
+			++(cached ? hits : misses);
+			if (c.erase(key) != cached || c.get(key)) return false;
+			++misses;
+			store.erase(key);
+		}
+		if (c.size() > c.capacity() || c.empty() != !c.size()) return false;
+	}
+	return c.stats().hits == hits && c.stats().misses == misses;
+}
+
+// a hot set which fits in the cache, read through while a scan of keys used
+// once goes on; the scan must not flush the hot set
+template<class Cache>
+double hotHitRatio(size_t capacity)
+{
+	Cache c(capacity);
+	for (int round = 0; round < 20; ++round)
+		for (int key = 0; key < (int)capacity / 2; ++key)
+			if (!c.get(key)) c.put(key, key);
+	c.reset_stats();
+	int scan = 1000000;
+	for (int i = 0; i < 20000; ++i) {
+		if (i % 2) {
+			int key = nextRand() % (capacity / 2);
+			if (!c.get(key)) c.put(key, key);
+		}
+		else c.put(scan++, 0);
+	}
+	return c.stats().hit_ratio();
+}
+
+// lru_cache with the constructor of the others
+struct lru : sjtu::lru_cache<int, int> {
+	explicit lru(size_t capacity): sjtu::lru_cache<int, int>(capacity) {}
+};
+
+int main()
+{
+	if (!checkValues<sjtu::two_queue_cache<int, int>>(1000)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!checkValues<sjtu::arc_cache<int, int>>(1000)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!checkValues<sjtu::tinylfu_cache<int, int>>(1000)) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!checkValues<sjtu::two_queue_cache<int, int>>(3)) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!checkValues<sjtu::arc_cache<int, int>>(3)) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!checkValues<sjtu::tinylfu_cache<int, int>>(3)) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	// plain lru loses the hot set to the scan, the others keep it
+	if (hotHitRatio<lru>(1000) > 0.8) std::cout << "Test 7 Failed......" << std::endl; else std::cout << "Test 7 Passed!" << std::endl;
+	if (hotHitRatio<sjtu::two_queue_cache<int, int>>(1000) < 0.9) std::cout << "Test 8 Failed......" << std::endl; else std::cout << "Test 8 Passed!" << std::endl;
+	if (hotHitRatio<sjtu::arc_cache<int, int>>(1000) < 0.9) std::cout << "Test 9 Failed......" << std::endl; else std::cout << "Test 9 Passed!" << std::endl;
+	if (hotHitRatio<sjtu::tinylfu_cache<int, int>>(1000) < 0.9) std::cout << "Test 10 Failed......" << std::endl; else std::cout << "Test 10 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,244 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// std::equal_to which counts its calls
+long long equalCalls = 0;
+struct countingEqual {
+	bool operator()(int a, int b) const {
+		++equalCalls;
+		return a == b;
+	}
+};
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+template<class Map>
+bool same(Map &m, const reference &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	typename Map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+		if (m.find(o->second) != it) return false;
+	}
+	if (it != m.end()) return false;
+	for (std::map<long long, int>::const_reverse_iterator o = r.order.rbegin(); o != r.order.rend(); ++o) {
+		--it;
+		if (it->first != o->second) return false;
+	}
+	return true;
+}
+
+typedef sjtu::linked_hashmap<int, int> map;
+
+// no table up to eight elements, a table from the ninth on; the contents agree throughout
+bool check1()
+{
+	for (int n = 0; n <= 20; ++n) {
+		sjtu::linked_hashmap<int, int, std::hash<int>, countingEqual> m;
+		reference r;
+		for (int i = 0; i < n; ++i) {
+			int key = nextRand() % 1000;
+			if (r.values.count(key)) continue;
+			m[key] = i;
+			r.insert(key, i);
+			if ((m.bucket_count() == 0) != (m.size() <= 8) || !same(m, r)) return false;
+		}
+		// a scan of the list compares cached hashes first, so only hits call equal
+		equalCalls = 0;
+		long long hits = 0;
+		for (int key = 0; key < 1000; ++key) {
+			bool exists = r.values.count(key);
+			if (m.count(key) != (size_t)exists) return false;
+			hits += exists;
+		}
+		if (equalCalls != hits) return false;
+	}
+	return true;
+}
+
+// erasing below nine keeps the table, unless min_load_factor lets clear() drop it
+bool check2()
+{
+	map m, shrinking;
+	reference r;
+	shrinking.min_load_factor(0.1f);
+	for (int i = 0; i < 9; ++i) {
+		m[i] = shrinking[i] = i;
+		r.insert(i, i);
+	}
+	if (m.bucket_count() == 0 || shrinking.bucket_count() == 0) return false;
+	for (int i = 0; i < 6; ++i) {
+		m.erase(m.find(i));
+		shrinking.erase(shrinking.find(i));
+		r.erase(i);
+	}
+	if (m.bucket_count() == 0 || !same(m, r) || !same(shrinking, r)) return false;
+	m.clear();
+	shrinking.clear();
+	if (m.bucket_count() == 0 || shrinking.bucket_count() != 0) return false;
+	// and both work on from there
+	reference empty;
+	for (int i = 0; i < 30; ++i) {
+		m[i * 7] = shrinking[i * 7] = i;
+		empty.insert(i * 7, i);
+	}
+	return same(m, empty) && same(shrinking, empty) && shrinking.bucket_count() != 0;
+}
+
+// reserve past eight and rehash with a bucket count build the table at once
+bool check3()
+{
+	map a, b, c, d;
+	a.reserve(8);
+	b.reserve(9);
+	c.rehash(0);
+	d.rehash(1);
+	if (a.bucket_count() != 0 || b.bucket_count() == 0 || c.bucket_count() != 0 || d.bucket_count() == 0) return false;
+	reference r;
+	for (int i = 0; i < 5; ++i) {
+		a[i] = b[i] = c[i] = d[i] = i;
+		r.insert(i, i);
+	}
+	return same(a, r) && same(b, r) && same(c, r) && same(d, r) && b.bucket_count() != 0;
+}
+
+// copies and assignments between empty, small and large maps own their own sentinels
+bool check4()
+{
+	const int sizes[4] = {0, 3, 8, 40};
+	for (int x = 0; x < 4; ++x)
+		for (int y = 0; y < 4; ++y) {
+			map from, to;
+			reference r, other;
+			for (int i = 0; i < sizes[x]; ++i) {
+				from[i] = i;
+				r.insert(i, i);
+			}
+			for (int i = 0; i < sizes[y]; ++i) {
+				to[-i] = i;
+				other.insert(-i, i);
+			}
+			map copy(from);
+			to = from;
+			to = to;
+			if (!same(copy, r) || !same(to, r)) return false;
+			if ((copy.bucket_count() == 0) != (sizes[x] <= 8)) return false;
+			if (copy.end() == from.end() || to.end() == from.end() || (sizes[x] && to.begin() == from.begin())) return false;
+			// changing one leaves the others alone
+			from[1000] = 1;
+			copy.clear();
+			to[2000] = 2;
+			r.insert(2000, 2);
+			if (!same(to, r) || !copy.empty() || from.size() != (size_t)sizes[x] + 1) return false;
+			// and an empty map copied over a full one empties it
+			to = map();
+			if (!to.empty() || to.begin() != to.end()) return false;
+			to[5] = 5;
+			if (to.size() != 1 || to.at(5) != 5) return false;
+		}
+	return true;
+}
+
+// many small maps side by side, each against its own std::map
+bool check5()
+{
+	const int N = 2000;
+	std::vector<map> maps(N);
+	std::vector<reference> refs(N);
+	for (int i = 0; i < 30000; ++i) {
+		int k = nextRand() % N, key = nextRand() % 16, op = nextRand() % 8;
+		map &m = maps[k];
+		reference &r = refs[k];
+		bool exists = r.values.count(key);
+		if (op < 3) {
+			m[key] = i;
+			if (!exists) r.insert(key, i);
+			else r.values[key] = i;
+		}
+		else if (op < 6) {
+			if (!exists) {
+				if (m.find(key) != m.end()) return false;
+				continue;
+			}
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		else if (op < 7) {
+			if (m.count(key) != (size_t)exists || (exists && m.at(key) != r.values[key])) return false;
+		}
+		else if (nextRand() % 50 == 0) {
+			int j = nextRand() % N;
+			maps[j] = m;
+			refs[j] = r;
+		}
+		if (i % 1000 == 0 && !same(m, r)) return false;
+	}
+	for (int k = 0; k < N; ++k)
+		if (!same(maps[k], refs[k])) return false;
+	return true;
+}
+
+// string keys across the switch
+bool check6()
+{
+	sjtu::linked_hashmap<std::string, std::string> m;
+	std::map<std::string, std::string> r;
+	for (int i = 0; i < 2000; ++i) {
+		std::string key = "key" + std::to_string(nextRand() % 12);
+		if (nextRand() % 2) {
+			m[key] = r[key] = std::to_string(i);
+		}
+		else if (r.count(key)) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		if (m.size() != r.size()) return false;
+		for (std::map<std::string, std::string>::iterator it = r.begin(); it != r.end(); ++it)
+			if (m.at(it->first) != it->second) return false;
+	}
+	return true;
+}
+
+int main()
+{
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!check5()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check6()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,180 @@
+#include "flat_linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+typedef sjtu::flat_linked_hashmap<int, int> map;
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+bool same(map &m, const reference &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+	}
+	if (it != m.end()) return false;
+	// and backwards
+	for (std::map<long long, int>::const_reverse_iterator o = r.order.rbegin(); o != r.order.rend(); ++o) {
+		--it;
+		if (it->first != o->second) return false;
+	}
+	return true;
+}
+
+bool check1(size_t compactPercent)
+{
+	map m;
+	m.set_compact_percent(compactPercent);
+	reference r;
+	for (int i = 0; i < 200000; ++i) {
+		int key = nextRand() % 3000, op = nextRand() % 8;
+		bool exists = r.values.count(key);
+		if (op < 2) {
+			int value = nextRand() % 1000000;
+			sjtu::pair<map::iterator, bool> res = m.insert(map::value_type(key, value));
+			if (res.second == exists || res.first->first != key) return false;
+			if (!exists) r.insert(key, value);
+		}
+		else if (op < 4) {
+			int value = nextRand() % 1000000;
+			m[key] = value;
+			if (!exists) r.insert(key, value);
+			else r.values[key] = value;
+		}
+		else if (op < 6) {
+			map::iterator it = m.find(key);
+			if ((it == m.end()) == exists) return false;
+			if (exists) {
+				m.erase(it);
+				r.erase(key);
+			}
+		}
+		else if (op < 7) {
+			if (m.count(key) != (size_t)exists) return false;
+			if (exists && m.at(key) != r.values[key]) return false;
+		}
+		else {
+			const map &c = m;
+			map::const_iterator it = c.find(key);
+			if ((it == c.cend()) == exists) return false;
+			if (exists && it->second != r.values[key]) return false;
+		}
+		if (i % 5000 == 0 && !same(m, r)) return false;
+	}
+	// with 0 any insertion compacts first
+	if (compactPercent == 0) {
+		m[-1] = -1;
+		r.insert(-1, -1);
+		if (m.tombstones() != 0) return false;
+	}
+	m.compact();
+	return m.tombstones() == 0 && same(m, r);
+}
+
+bool check2()
+{
+	map m;
+	reference r;
+	for (int i = 0; i < 10000; ++i) {
+		int key = nextRand() % 20000;
+		if (!r.values.count(key)) {
+			m[key] = i;
+			r.insert(key, i);
+		}
+	}
+	for (int i = 0; i < 3000; ++i) {
+		int key = nextRand() % 20000;
+		if (r.values.count(key)) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+	}
+	map c(m), d;
+	d[1] = 1;
+	d = m;
+	d = d;
+	if (!same(c, r) || !same(d, r)) return false;
+	// the copies do not share anything
+	c.clear();
+	d[-1] = -1;
+	return c.empty() && same(m, r) && d.size() == m.size() + 1;
+}
+
+bool check3()
+{
+	map m, other;
+	m[1] = 1;
+	other[1] = 1;
+	int thrown = 0;
+	try {m.at(2);} catch (sjtu::index_out_of_bound &) {++thrown;}
+	try {m.erase(m.end());} catch (sjtu::invalid_iterator &) {++thrown;}
+	try {m.erase(other.begin());} catch (sjtu::invalid_iterator &) {++thrown;}
+	try {*m.end();} catch (sjtu::invalid_iterator &) {++thrown;}
+	const map &c = m;
+	try {c[5];} catch (sjtu::index_out_of_bound &) {++thrown;}
+	return thrown == 5 && m.size() == 1;
+}
+
+bool check4()
+{
+	sjtu::flat_linked_hashmap<std::string, std::string> m;
+	std::map<std::string, std::string> r;
+	for (int i = 0; i < 50000; ++i) {
+		std::string key = "key" + std::to_string(nextRand() % 5000);
+		if (nextRand() % 3) {
+			std::string value = std::to_string(i);
+			m[key] = value;
+			r[key] = value;
+		}
+		else if (r.count(key)) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+	}
+	if (m.size() != r.size()) return false;
+	for (std::map<std::string, std::string>::iterator it = r.begin(); it != r.end(); ++it)
+		if (m.at(it->first) != it->second) return false;
+	return true;
+}
+
+int main()
+{
+	if (!check1(25)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check1(0)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check1(1000)) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check4()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// a batch of n keys, found and counted at once, agrees with std::map and with find() one by one
+template<class Map, class Key>
+bool sameBatch(Map &m, const std::map<Key, int> &r, const std::vector<Key> &keys)
+{
+	size_t n = keys.size();
+	const Key *k = n ? &keys[0] : nullptr;
+	std::vector<typename Map::iterator> found(n, m.end());
+	std::vector<typename Map::const_iterator> constFound(n, m.cend());
+	std::vector<size_t> counted(n, 2);
+	const Map &c = m;
+	m.find_batch(k, n, n ? &found[0] : nullptr);
+	c.find_batch(k, n, n ? &constFound[0] : nullptr);
+	size_t total = c.count_batch(k, n, n ? &counted[0] : nullptr), hits = 0;
+	if (c.count_batch(k, n) != total) return false;
+	for (size_t i = 0; i < n; ++i) {
+		typename std::map<Key, int>::const_iterator it = r.find(keys[i]);
+		bool exists = it != r.end();
+		hits += exists;
+		if (found[i] != m.find(keys[i]) || constFound[i] != c.find(keys[i]) || counted[i] != (size_t)exists) return false;
+		if (exists && (found[i]->second != it->second || constFound[i]->second != it->second)) return false;
+	}
+	return total == hits;
+}
+
+// batches of every length between inserts and erases, from a map with no table through many
+// incremental rehashes, with keys present, missing and repeated
+template<class Policy>
+bool check1()
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	map m;
+	std::map<int, int> r;
+	std::vector<int> present;
+	for (int i = 0; i < 100000; ++i) {
+		int key = nextRand() % 1000000;
+		if (nextRand() % 5) {
+			m[key] = i;
+			if (!r.count(key)) present.push_back(key);
+			r[key] = i;
+		}
+		else if (r.count(key)) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		if (i < 100 || i % 97 == 0) {
+			size_t n = i < 100 ? i % 40 : nextRand() % 300;
+			std::vector<int> keys;
+			for (size_t j = 0; j < n; ++j) {
+				int kind = nextRand() % 3;
+				if (kind == 0 && !present.empty()) keys.push_back(present[nextRand() % present.size()]);
+				else if (kind == 1 && !keys.empty()) keys.push_back(keys[nextRand() % keys.size()]);
+				else keys.push_back(nextRand() % 1000000);
+			}
+			if (!sameBatch(m, r, keys)) return false;
+		}
+	}
+	return true;
+}
+
+// a batch of every key after clear and on an empty map
+bool check2()
+{
+	sjtu::linked_hashmap<int, int> m;
+	std::map<int, int> r;
+	std::vector<int> keys;
+	for (int i = 0; i < 5000; ++i) keys.push_back(i);
+	if (!sameBatch(m, r, keys)) return false;
+	for (int i = 0; i < 5000; i += 2) m[i] = r[i] = i;
+	if (!sameBatch(m, r, keys)) return false;
+	m.clear();
+	r.clear();
+	return sameBatch(m, r, keys) && m.count_batch(&keys[0], keys.size()) == 0;
+}
+
+// string keys
+bool check3()
+{
+	sjtu::linked_hashmap<std::string, int> m;
+	std::map<std::string, int> r;
+	for (int i = 0; i < 20000; ++i) {
+		std::string key = "key" + std::to_string(nextRand() % 30000);
+		m[key] = r[key] = i;
+	}
+	std::vector<std::string> keys;
+	for (int i = 0; i < 20000; ++i) keys.push_back("key" + std::to_string(nextRand() % 60000));
+	return sameBatch(m, r, keys);
+}
+
+int main()
+{
+	if (!check1<sjtu::prime_mod_policy>()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check1<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	return 0;
+}
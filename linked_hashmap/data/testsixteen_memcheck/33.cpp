@@ -0,0 +1,181 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// a value which counts how it is made and assigned
+long long made = 0, copied = 0, moved = 0, assigned = 0;
+struct tracked {
+	int a, b;
+	tracked(): a(0), b(0) {++made;}
+	tracked(int _a, int _b): a(_a), b(_b) {++made;}
+	tracked(const tracked &other): a(other.a), b(other.b) {++copied;}
+	tracked(tracked &&other): a(other.a), b(other.b) {++moved;}
+	tracked &operator=(const tracked &other) {a = other.a; b = other.b; ++assigned; return *this;}
+	tracked &operator=(tracked &&other) {a = other.a; b = other.b; ++assigned; return *this;}
+};
+void resetCounts() {made = copied = moved = assigned = 0;}
+bool counts(long long m, long long c, long long mv, long long as) {return made == m && copied == c && moved == mv && assigned == as;}
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+typedef sjtu::linked_hashmap<int, tracked> map;
+
+bool same(map &m, const reference &r)
+{
+	if (m.size() != r.values.size()) return false;
+	map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second.a != r.values.find(o->second)->second) return false;
+	}
+	return it == m.end();
+}
+
+// sjtu::pair cannot be assigned, keep its parts
+void record(const sjtu::pair<map::iterator, bool> &res, map::iterator &at, bool &inserted)
+{
+	at = res.first;
+	inserted = res.second;
+}
+
+// emplace, try_emplace, insert_or_assign and operator[] against std::map; a new value is
+// made once in place, a present key is assigned in place and keeps its position
+bool check1()
+{
+	map m;
+	reference r;
+	for (int i = 0; i < 20000; ++i) {
+		int key = nextRand() % 5000, op = nextRand() % 6;
+		bool exists = r.values.count(key);
+		map::iterator at = m.end();
+		bool inserted = false;
+		resetCounts();
+		if (op == 0) {
+			record(m.try_emplace(key, i, -i), at, inserted);
+			if (!(exists ? counts(0, 0, 0, 0) : counts(1, 0, 0, 0))) return false;
+			if (!exists) r.insert(key, i);
+		}
+		else if (op == 1) {
+			record(m.insert_or_assign(key, tracked(i, -i)), at, inserted);
+			if (!(exists ? counts(1, 0, 0, 1) : counts(1, 0, 1, 0))) return false;
+			if (!exists) r.insert(key, i);
+			else r.values[key] = i;
+		}
+		else if (op == 2) {
+			record(m.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(i, -i)), at, inserted);
+			// emplace makes the element before it can look the key up
+			if (!counts(1, 0, 0, 0)) return false;
+			if (!exists) r.insert(key, i);
+		}
+		else if (op == 3) {
+			m[key].a = i;
+			if (!(exists ? counts(0, 0, 0, 0) : counts(1, 0, 0, 0))) return false;
+			if (!exists) r.insert(key, i);
+			else r.values[key] = i;
+			continue;
+		}
+		else if (op == 4) {
+			if (!exists) continue;
+			m.erase(m.find(key));
+			r.erase(key);
+			continue;
+		}
+		else {
+			const tracked value(i, -i);
+			resetCounts();
+			record(m.insert_or_assign(key, value), at, inserted);
+			if (!(exists ? counts(0, 0, 0, 1) : counts(0, 1, 0, 0))) return false;
+			if (!exists) r.insert(key, i);
+			else r.values[key] = i;
+		}
+		if (inserted == exists || at == m.end() || at->first != key || at->second.a != r.values[key]) return false;
+		if (i % 5000 == 0 && !same(m, r)) return false;
+	}
+	return same(m, r);
+}
+
+// try_emplace leaves its arguments alone when the key exists, insert_or_assign moves into place
+bool check2()
+{
+	sjtu::linked_hashmap<std::string, std::unique_ptr<int>> m;
+	std::unique_ptr<int> p(new int(1));
+	if (!m.try_emplace("one", std::move(p)).second || p || *m.at("one") != 1) return false;
+	std::unique_ptr<int> q(new int(2));
+	if (m.try_emplace("one", std::move(q)).second || !q || *q != 2 || *m.at("one") != 1) return false;
+	std::string key = "two";
+	if (!m.try_emplace(std::move(key), std::move(q)).second || q || *m.at("two") != 2) return false;
+	std::unique_ptr<int> r(new int(3));
+	sjtu::pair<sjtu::linked_hashmap<std::string, std::unique_ptr<int>>::iterator, bool> res = m.insert_or_assign("one", std::move(r));
+	if (res.second || r || *res.first->second != 3 || res.first != m.begin()) return false;
+	m["three"].reset(new int(4));
+	// emplace with a present key destroys the element it made, and the map keeps its own
+	if (m.emplace("three", std::unique_ptr<int>(new int(5))).second || *m.at("three") != 4) return false;
+	if (!m.emplace(std::string("four"), std::unique_ptr<int>(new int(6))).second) return false;
+	int expect[4] = {3, 2, 4, 6};
+	int k = 0;
+	for (sjtu::linked_hashmap<std::string, std::unique_ptr<int>>::iterator it = m.begin(); it != m.end(); ++it, ++k)
+		if (*it->second != expect[k]) return false;
+	return k == 4;
+}
+
+// values which can only be made in place
+struct pinned {
+	int x;
+	std::string s;
+	pinned(int _x, const char *_s): x(_x), s(_s) {}
+	pinned(const pinned &) = delete;
+	pinned &operator=(const pinned &) = delete;
+};
+
+bool check3()
+{
+	sjtu::linked_hashmap<int, pinned> m;
+	for (int i = 0; i < 1000; ++i)
+		if (!m.try_emplace(i, i * 2, "pinned").second) return false;
+	if (m.try_emplace(5, -1, "again").second || m.at(5).x != 10) return false;
+	if (!m.emplace(std::piecewise_construct, std::forward_as_tuple(-1), std::forward_as_tuple(7, "seven")).second) return false;
+	int i = 0;
+	for (sjtu::linked_hashmap<int, pinned>::iterator it = m.begin(); it != m.end(); ++it, ++i)
+		if (i < 1000 ? it->first != i || it->second.x != i * 2 : it->first != -1 || it->second.s != "seven") return false;
+	return i == 1001;
+}
+
+int main()
+{
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
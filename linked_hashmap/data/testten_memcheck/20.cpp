@@ -0,0 +1,219 @@
+#include "ttl_linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+typedef sjtu::ttl_linked_hashmap<int, int> ttl_map;
+const unsigned long long NEVER = ttl_map::NEVER;
+
+// the entries on std::map: value and deadline by key, and the keys in list order
+struct reference {
+	std::map<int, std::pair<int, unsigned long long>> entries;
+	std::map<long long, int> order;
+	std::map<int, long long> position;
+	long long clock;
+	unsigned long long now;
+
+	reference(): clock(0), now(0) {}
+	bool live(int key) {return entries.count(key) && entries[key].second > now;}
+	void remove(int key)
+	{
+		if (!entries.count(key)) return;
+		order.erase(position[key]);
+		position.erase(key);
+		entries.erase(key);
+	}
+	// key goes to the back of the list
+	void put(int key, int value, unsigned long long ttl)
+	{
+		remove(key);
+		entries[key] = std::make_pair(value, ttl >= NEVER - now ? NEVER : now + ttl);
+		order[clock] = key;
+		position[key] = clock++;
+	}
+};
+
+// the map holds what the reference holds, in the same order. expire() may
+// have dropped expired entries the reference still has, drop them too
+bool same(ttl_map &m, reference &r)
+{
+	std::map<long long, int>::iterator it = r.order.begin();
+	for (ttl_map::iterator p = m.begin(); p != m.end(); ++p, ++it) {
+		while (it != r.order.end() && it->second != p->first) {
+			if (r.live(it->second)) return false;
+			int key = (it++)->second;
+			r.remove(key);
+		}
+		if (it == r.order.end()) return false;
+		if (r.entries[p->first] != std::make_pair(p->second.value, p->second.deadline)) return false;
+	}
+	while (it != r.order.end()) {
+		if (r.live(it->second)) return false;
+		int key = (it++)->second;
+		r.remove(key);
+	}
+	return m.size() == r.entries.size();
+}
+
+// every operation on a small key set; uniform maps only use the default ttl,
+// which keeps the list sorted by deadline
+bool check(bool uniform, int ops)
+{
+	unsigned long long defaultTtl = uniform ? 50 : NEVER;
+	ttl_map m(defaultTtl);
+	reference r;
+	for (int i = 0; i < ops; ++i) {
+		int key = nextRand() % 300, op = nextRand() % 13;
+		unsigned long long ttl = uniform ? 50 : nextRand() % 100;
+		if (op < 3) {
+			int value = nextRand() % 1000000;
+			if (uniform) m.put(key, value);
+			else m.put(key, value, ttl);
+			r.put(key, value, ttl);
+		}
+		else if (op < 4) {
+			int value = nextRand() % 1000000;
+			bool live = r.live(key);
+			sjtu::pair<ttl_map::iterator, bool> res = uniform ? m.insert(key, value) : m.insert(key, value, ttl);
+			if (res.second == live) return false;
+			if (!live) r.put(key, value, ttl);
+			if (res.first->first != key || res.first->second.value != r.entries[key].first) return false;
+		}
+		else if (op < 5) {
+			ttl_map::iterator it = m.find(key);
+			if ((it == m.end()) == r.live(key)) return false;
+			if (it == m.end()) r.remove(key);
+			else if (it->second.value != r.entries[key].first) return false;
+		}
+		else if (op < 6) {
+			const ttl_map &cm = m;
+			if (cm.count(key) != (r.live(key) ? 1u : 0u)) return false;
+			ttl_map::const_iterator it = cm.find(key);
+			if ((it == cm.cend()) == r.live(key)) return false;
+		}
+		else if (op < 7) {
+			try {
+				int value = m.at(key);
+				if (!r.live(key) || value != r.entries[key].first) return false;
+			}
+			catch (sjtu::index_out_of_bound &) {
+				if (r.live(key)) return false;
+				r.remove(key);
+			}
+		}
+		else if (op < 8) {
+			ttl_map::iterator it = m.find(key);
+			if (it == m.end()) r.remove(key);
+			else {
+				m.erase(it);
+				r.remove(key);
+			}
+		}
+		else if (op < 9) {
+			int &value = m[key];
+			if (!r.live(key)) r.put(key, 0, defaultTtl);
+			if (value != r.entries[key].first) return false;
+			value = nextRand() % 1000000;
+			r.entries[key].first = value;
+		}
+		else {
+			unsigned long long now = r.now + nextRand() % 5;
+			size_t maxItems = nextRand() % 20, expired = 0;
+			for (std::map<long long, int>::iterator it = r.order.begin(); it != r.order.end() && r.entries[it->second].second <= now; ++it)
+				++expired;
+			size_t size = m.size(), erased = m.expire(now, maxItems);
+			r.now = now;
+			if (m.now() != now || m.size() != size - erased || erased > maxItems) return false;
+			// sorted by deadline, expired entries go from the front
+			if (uniform && erased != (expired < maxItems ? expired : maxItems)) return false;
+		}
+		if (!same(m, r)) return false;
+	}
+	// a full sweep leaves only the live entries
+	m.expire(r.now + 1, ~(size_t)0);
+	r.now += 1;
+	same(m, r);
+	for (ttl_map::iterator p = m.begin(); p != m.end(); ++p)
+		if (p->second.deadline <= r.now) return false;
+	for (std::map<int, std::pair<int, unsigned long long>>::iterator it = r.entries.begin(); it != r.entries.end(); ++it)
+		if (it->second.second <= r.now) return false;
+	return true;
+}
+
+// once the entries out of deadline order are gone, expire() erases from the
+// front again instead of going on round robin from where it stopped
+bool checkResorted()
+{
+	ttl_map m;
+	m.put(0, 0, 100);
+	for (int i = 1; i <= 100; ++i) m.put(i, i, 10);
+	// nothing has expired, the sweep stops at key 9
+	if (m.expire(5, 10) != 0) return false;
+	m.erase(m.find(0));
+	if (m.expire(20, 30) != 30 || m.size() != 70 || m.begin()->first != 31) return false;
+	for (int i = 101; i <= 110; ++i) m.put(i, i, 10);
+	if (m.expire(25, 1000) != 70 || m.size() != 10) return false;
+	return m.begin()->first == 101;
+}
+
+// copies are independent and keep the clock
+bool checkCopy()
+{
+	ttl_map m(10);
+	for (int i = 0; i < 100; ++i) m.put(i, i);
+	m.advance(5);
+	ttl_map n(m);
+	n.put(100, 100);
+	m.expire(10, 1000);
+	if (m.size() != 0 || n.size() != 101 || n.now() != 5) return false;
+	m = n;
+	m.expire(14, 1000);
+	if (m.size() != 1 || m.at(100) != 100 || n.size() != 101) return false;
+	n.clear();
+	return n.empty() && m.size() == 1 && n.count(100) == 0;
+}
+
+// a ttl past the end of the clock never expires
+bool checkNever()
+{
+	ttl_map m(NEVER, NEVER - 10);
+	m.put(0, 0, 20);
+	m.put(1, 1);
+	m.put(2, 2, 5);
+	m.expire(NEVER - 1, 1000);
+	return m.size() == 2 && m.count(0) && m.count(1) && !m.count(2);
+}
+
+bool checkStringKeys()
+{
+	sjtu::ttl_linked_hashmap<std::string, std::string> m(3);
+	std::map<std::string, std::string> r;
+	for (int i = 0; i < 1000; ++i) {
+		std::string key = std::to_string(nextRand() % 100), value = std::to_string(nextRand());
+		m.put(key, value);
+		r[key] = value;
+		if (m.at(key) != r[key]) return false;
+	}
+	m.expire(m.now() + 3, 1000);
+	return m.empty();
+}
+
+int main()
+{
+	if (!check(true, 30000)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check(false, 30000)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!checkResorted()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!checkCopy()) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!checkNever()) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!checkStringKeys()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,169 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// the contents of a map, and the keys in insertion order by a running counter
+template<class Key>
+struct reference {
+	std::map<Key, int> values;
+	std::map<long long, Key> order;
+	std::map<Key, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(const Key &key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(const Key &key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+template<class Map, class Key>
+bool same(Map &m, const reference<Key> &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	typename Map::iterator it = m.begin();
+	for (typename std::map<long long, Key>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+	}
+	return it == m.end();
+}
+
+bool powerOfTwo(size_t n) {return n && !(n & (n - 1));}
+
+// random operations against std::map, on keys which are multiples of stride
+template<class Policy>
+bool check1(int stride)
+{
+	typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	map m;
+	reference<int> r;
+	for (int i = 0; i < 200000; ++i) {
+		int key = (int)(nextRand() % 20000) * stride, op = nextRand() % 6;
+		bool exists = r.values.count(key);
+		if (op < 2) {
+			int value = nextRand() % 1000000;
+			sjtu::pair<typename map::iterator, bool> res = m.insert(typename map::value_type(key, value));
+			if (res.second == exists || res.first->first != key) return false;
+			if (!exists) r.insert(key, value);
+		}
+		else if (op < 3) {
+			int value = nextRand() % 1000000;
+			m[key] = value;
+			if (!exists) r.insert(key, value);
+			else r.values[key] = value;
+		}
+		else if (op < 5) {
+			typename map::iterator it = m.find(key);
+			if ((it == m.end()) == exists) return false;
+			if (exists) {
+				m.erase(it);
+				r.erase(key);
+			}
+		}
+		else {
+			if (m.count(key) != (size_t)exists) return false;
+			if (exists && m.at(key) != r.values[key]) return false;
+		}
+		if (i % 5000 == 0 && !same(m, r)) return false;
+	}
+	map c(m), d;
+	d = m;
+	return same(m, r) && same(c, r) && same(d, r);
+}
+
+// the table of a power-of-two policy stays a power of two, through growth, reserve and rehash
+template<class Policy>
+bool check2()
+{
+	sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, Policy> m;
+	for (int i = 0; i < 100000; ++i) {
+		m[i] = i;
+		if (m.bucket_count() && !powerOfTwo(m.bucket_count())) return false;
+	}
+	m.reserve(300000);
+	if (!powerOfTwo(m.bucket_count())) return false;
+	m.rehash(1000000);
+	if (!powerOfTwo(m.bucket_count()) || m.bucket_count() < 1000000) return false;
+	m.rehash(0);
+	if (!powerOfTwo(m.bucket_count()) || m.load_factor() > m.max_load_factor()) return false;
+	for (int i = 0; i < 100000; ++i)
+		if (m.at(i) != i) return false;
+	return true;
+}
+
+// std::hash<int> is the identity, so sequential and strided keys differ only in their high
+// or low bits. masking them unmixed would use capacity / stride buckets, the mixing must
+// spread them over a good part of the table
+template<class Policy>
+bool check3()
+{
+	const size_t capacity = 1 << 14;
+	const int strides[4] = {1, 64, 4096, 1 << 20};
+	for (int s = 0; s < 4; ++s) {
+		std::set<size_t> used;
+		for (size_t k = 0; k < capacity / 2; ++k) {
+			size_t index = Policy::index(std::hash<size_t>()(k * strides[s]), capacity);
+			if (index >= capacity) return false;
+			used.insert(index);
+		}
+		if (used.size() < capacity / 8) return false;
+	}
+	return true;
+}
+
+// string keys through a power-of-two table
+template<class Policy>
+bool check4()
+{
+	sjtu::linked_hashmap<std::string, int, std::hash<std::string>, std::equal_to<std::string>, Policy> m;
+	reference<std::string> r;
+	for (int i = 0; i < 50000; ++i) {
+		std::string key = "key" + std::to_string(nextRand() % 5000);
+		bool exists = r.values.count(key);
+		if (nextRand() % 3) {
+			m[key] = i;
+			if (!exists) r.insert(key, i);
+			else r.values[key] = i;
+		}
+		else if (exists) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+	}
+	return same(m, r);
+}
+
+int main()
+{
+	if (!check1<sjtu::pow2_fibonacci_policy>(1)) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check1<sjtu::pow2_fibonacci_policy>(1024)) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check1<sjtu::pow2_murmur_policy>(1)) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	if (!check1<sjtu::pow2_murmur_policy>(1024)) std::cout << "Test 4 Failed......" << std::endl; else std::cout << "Test 4 Passed!" << std::endl;
+	if (!check1<sjtu::prime_mod_policy>(1024)) std::cout << "Test 5 Failed......" << std::endl; else std::cout << "Test 5 Passed!" << std::endl;
+	if (!check2<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 6 Failed......" << std::endl; else std::cout << "Test 6 Passed!" << std::endl;
+	if (!check2<sjtu::pow2_murmur_policy>()) std::cout << "Test 7 Failed......" << std::endl; else std::cout << "Test 7 Passed!" << std::endl;
+	if (!check3<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 8 Failed......" << std::endl; else std::cout << "Test 8 Passed!" << std::endl;
+	if (!check3<sjtu::pow2_murmur_policy>()) std::cout << "Test 9 Failed......" << std::endl; else std::cout << "Test 9 Passed!" << std::endl;
+	if (!check4<sjtu::pow2_fibonacci_policy>()) std::cout << "Test 10 Failed......" << std::endl; else std::cout << "Test 10 Passed!" << std::endl;
+	if (!check4<sjtu::pow2_murmur_policy>()) std::cout << "Test 11 Failed......" << std::endl; else std::cout << "Test 11 Passed!" << std::endl;
+	return 0;
+}
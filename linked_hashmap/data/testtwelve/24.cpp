@@ -0,0 +1,149 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <map>
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// std::hash and std::equal_to which count their calls
+long long hashCalls = 0, equalCalls = 0;
+struct countingHash {
+	size_t operator()(int x) const {
+		++hashCalls;
+		return std::hash<int>()(x);
+	}
+};
+struct countingEqual {
+	bool operator()(int a, int b) const {
+		++equalCalls;
+		return a == b;
+	}
+};
+// sixteen hash codes for all keys, so chains are long and equal decides
+struct fewHash {
+	size_t operator()(int x) const {return (size_t)(x & 15);}
+};
+
+// the contents of a map, and the keys in insertion order by a running counter
+struct reference {
+	std::map<int, int> values;
+	std::map<long long, int> order;
+	std::map<int, long long> stamp;
+	long long counter;
+
+	reference(): counter(0) {}
+	void insert(int key, int value)
+	{
+		values[key] = value;
+		order[counter] = key;
+		stamp[key] = counter++;
+	}
+	void erase(int key)
+	{
+		values.erase(key);
+		order.erase(stamp[key]);
+		stamp.erase(key);
+	}
+};
+
+template<class Map>
+bool same(Map &m, const reference &r)
+{
+	if (m.size() != r.values.size() || m.empty() != r.values.empty()) return false;
+	typename Map::iterator it = m.begin();
+	for (std::map<long long, int>::const_iterator o = r.order.begin(); o != r.order.end(); ++o, ++it) {
+		if (it == m.end() || it->first != o->second || it->second != r.values.find(o->second)->second) return false;
+	}
+	return it == m.end();
+}
+
+typedef sjtu::linked_hashmap<int, int, countingHash, countingEqual> map;
+
+// every lookup hashes its key once, growing and copying the table never does
+bool check1()
+{
+	map m;
+	reference r;
+	long long lookups = 0;
+	hashCalls = 0;
+	for (int i = 0; i < 300000; ++i) {
+		int key = nextRand() % 50000, op = nextRand() % 4;
+		bool exists = r.values.count(key);
+		if (op < 2) {
+			int value = nextRand() % 1000000;
+			m[key] = value;
+			if (!exists) r.insert(key, value);
+			else r.values[key] = value;
+		}
+		else if (op < 3) {
+			map::iterator it = m.find(key);
+			if ((it == m.end()) == exists) return false;
+			// erasing by iterator needs no hash
+			if (exists) {
+				m.erase(it);
+				r.erase(key);
+			}
+		}
+		else {
+			if (m.count(key) != (size_t)exists) return false;
+		}
+		++lookups;
+		if (hashCalls != lookups) return false;
+	}
+	map c(m), d;
+	d = m;
+	m.rehash(m.bucket_count() * 4);
+	m.reserve(m.size() * 8);
+	if (hashCalls != lookups) return false;
+	return same(m, r) && same(c, r) && same(d, r);
+}
+
+// equal is only asked about keys of the same hash: std::hash<int> gives every key
+// its own, so a lookup calls equal once if it hits and never if it misses
+bool check2()
+{
+	map m;
+	long long hits = 0;
+	for (int i = 0; i < 100000; ++i) m[(int)(nextRand() % 1000000)] = i;
+	equalCalls = 0;
+	for (int i = 0; i < 200000; ++i) hits += m.count((int)(nextRand() % 1000000));
+	return hits > 0 && equalCalls == hits;
+}
+
+// long chains of one hash code against std::map
+bool check3()
+{
+	sjtu::linked_hashmap<int, int, fewHash> m;
+	reference r;
+	for (int i = 0; i < 30000; ++i) {
+		int key = nextRand() % 2000, op = nextRand() % 3;
+		bool exists = r.values.count(key);
+		if (op < 2) {
+			int value = nextRand() % 1000000;
+			sjtu::pair<sjtu::linked_hashmap<int, int, fewHash>::iterator, bool> res = m.insert(sjtu::pair<const int, int>(key, value));
+			if (res.second == exists || res.first->first != key) return false;
+			if (!exists) r.insert(key, value);
+		}
+		else if (exists) {
+			m.erase(m.find(key));
+			r.erase(key);
+		}
+		else if (m.find(key) != m.end()) return false;
+		if (i % 1000 == 0 && !same(m, r)) return false;
+	}
+	return same(m, r);
+}
+
+int main()
+{
+	if (!check1()) std::cout << "Test 1 Failed......" << std::endl; else std::cout << "Test 1 Passed!" << std::endl;
+	if (!check2()) std::cout << "Test 2 Failed......" << std::endl; else std::cout << "Test 2 Passed!" << std::endl;
+	if (!check3()) std::cout << "Test 3 Failed......" << std::endl; else std::cout << "Test 3 Passed!" << std::endl;
+	return 0;
+}
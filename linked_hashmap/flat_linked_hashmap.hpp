@@ -0,0 +1,583 @@
+/**
+ * a linked_hashmap built on open addressing (a swiss table)
+ */
+#ifndef SJTU_FLAT_LINKEDHASHMAP_HPP
+#define SJTU_FLAT_LINKEDHASHMAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "utility.hpp"
+#include "exceptions.hpp"
+
+namespace sjtu {
+
+/**
+ * sixteen control bytes of the swiss table, probed together.
+ * a control byte is EMPTY, DELETED, or the low 7 bits of the hash (H2)
+ * of the entry in that slot, so one SSE2 compare finds every slot of the
+ * group which may hold a key.
+ */
+class swiss_group {
+public:
+	static const int WIDTH = 16;
+	static const signed char EMPTY = -128, DELETED = -2;
+
+#ifdef __SSE2__
+private:
+	__m128i ctrl;
+public:
+	explicit swiss_group(const signed char *p): ctrl(_mm_loadu_si128((const __m128i *)p)) {}
+	unsigned match(signed char h2) const {return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));}
+	unsigned match_empty() const {return match(EMPTY);}
+	// EMPTY and DELETED are the only negative control bytes
+	unsigned match_free() const {return _mm_movemask_epi8(ctrl);}
+#else
+private:
+	const signed char *ctrl;
+public:
+	explicit swiss_group(const signed char *p): ctrl(p) {}
+	unsigned match(signed char h2) const {
+		unsigned ret = 0;
+		for (int i = 0; i < WIDTH; ++i)
+			if (ctrl[i] == h2) ret |= 1u << i;
+		return ret;
+	}
+	unsigned match_empty() const {return match(EMPTY);}
+	unsigned match_free() const {
+		unsigned ret = 0;
+		for (int i = 0; i < WIDTH; ++i)
+			if (ctrl[i] < 0) ret |= 1u << i;
+		return ret;
+	}
+#endif
+};
+
+/**
+ * the same interface as linked_hashmap, with a different layout:
+ * entries live in one dense array in insertion order, and the hash
+ * index is a swiss table whose groups hold the control bytes and the
+ * entry indices of GROUP_SLOTS slots in one 64-byte line. a lookup
+ * loads one group, compares all its H2 tags at once and only touches
+ * entries whose tag and full hash match, so a hit reads one line of
+ * the index and then its entry.
+ *
+ * erase() leaves a dead entry (a tombstone) behind, it never moves
+ * other entries, so iterators and insertion order stay intact. once
+ * COMPACT_PERCENT percent of the entry array are tombstones, the next
+ * insertion compacts it, which keeps a scan proportional to size() at
+ * an amortized O(1) cost per erase. compaction moves entries, so it
+ * invalidates iterators, like a rebuild of the index does.
+ *
+ * values live in the entry array itself, so whatever may insert
+ * (operator[] and insert) may grow or compact it and move every value:
+ * it invalidates references and pointers into the map as well as
+ * iterators. m[a] = m[b] reads a moved-from value if m[a] inserts;
+ * copy m[b] out first.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class flat_linked_hashmap {
+	public:
+		using value_type = pair<const Key, T>;
+
+	private:
+		struct entry {
+			size_t hash;
+			bool alive;
+			typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+
+			value_type *value() {return reinterpret_cast<value_type *>(&storage);}
+			const value_type *value() const {return reinterpret_cast<const value_type *>(&storage);}
+		};
+
+		static const size_t INITIAL_CAPACITY = 16, INITIAL_GROUPS = 2, COMPACT_PERCENT = 25, NPOS = ~(size_t)0;
+		static const int WIDTH = swiss_group::WIDTH;
+		static const int GROUP_SLOTS = (64 - WIDTH) / sizeof(uint32_t);
+
+		// the control bytes past GROUP_SLOTS stay DELETED: never matched,
+		// never empty, and masked off when looking for a free slot
+		struct group {
+			signed char ctrl[WIDTH];
+			uint32_t index[GROUP_SLOTS];
+		};
+		static const unsigned SLOT_MASK = (1u << GROUP_SLOTS) - 1;
+
+		entry *entries;
+		size_t entryCount, entryCapacity, len;
+		// groups is aligned to 64 bytes inside groupMemory
+		void *groupMemory;
+		group *groups;
+		size_t groupCount, used;
+		size_t compactPercent;
+		Hash hash;
+		Equal equal;
+
+		// murmur3 finalizer, spreads identity hashes such as std::hash<int> over all bits
+		static size_t mix(size_t h)
+		{
+			unsigned long long x = h;
+			x ^= x >> 33;
+			x *= 0xff51afd7ed558ccdULL;
+			x ^= x >> 33;
+			x *= 0xc4ceb9fe1a85ec53ULL;
+			x ^= x >> 33;
+			return (size_t)x;
+		}
+		static signed char h2(size_t h) {return (signed char)(h & 0x7f);}
+
+		size_t groupMask() const {return groupCount - 1;}
+		size_t capacity() const {return groupCount * GROUP_SLOTS;}
+
+		// a slot is numbered group * WIDTH + its position in the group
+		signed char & ctrlOf(size_t slot) {return groups[slot / WIDTH].ctrl[slot % WIDTH];}
+
+		void resetIndex()
+		{
+			for (size_t g = 0; g < groupCount; ++g) {
+				memset(groups[g].ctrl, swiss_group::EMPTY, GROUP_SLOTS);
+				memset(groups[g].ctrl + GROUP_SLOTS, swiss_group::DELETED, WIDTH - GROUP_SLOTS);
+			}
+			used = 0;
+		}
+		void newIndex()
+		{
+			groupMemory = malloc(groupCount * sizeof(group) + 63);
+			groups = (group *)(((size_t)groupMemory + 63) / 64 * 64);
+			resetIndex();
+		}
+
+		// place entry e into the first free slot of its probe sequence
+		void placeIndex(size_t e)
+		{
+			size_t h = entries[e].hash, mask = groupMask(), g = (h >> 7) & mask;
+			for (size_t step = 0; ; g = (g + ++step) & mask) {
+				unsigned m = swiss_group(groups[g].ctrl).match_free() & SLOT_MASK;
+				if (m) {
+					int i = __builtin_ctz(m);
+					if (groups[g].ctrl[i] == swiss_group::EMPTY) ++used;
+					groups[g].ctrl[i] = h2(h);
+					groups[g].index[i] = (uint32_t)e;
+					return;
+				}
+			}
+		}
+
+		// the slot of the index which points at entry e
+		size_t slotOf(size_t e) const
+		{
+			size_t h = entries[e].hash, mask = groupMask(), g = (h >> 7) & mask;
+			for (size_t step = 0; ; g = (g + ++step) & mask) {
+				for (unsigned m = swiss_group(groups[g].ctrl).match(h2(h)); m; m &= m - 1) {
+					int i = __builtin_ctz(m);
+					if (groups[g].index[i] == e) return g * WIDTH + i;
+				}
+			}
+		}
+
+		void growEntries()
+		{
+			size_t cap = entryCapacity ? entryCapacity * 2 : INITIAL_CAPACITY;
+			entry *tmp = (entry *)malloc(cap * sizeof(entry));
+			for (size_t i = 0; i < entryCount; ++i) {
+				tmp[i].hash = entries[i].hash;
+				tmp[i].alive = entries[i].alive;
+				if (entries[i].alive) {
+					new(tmp[i].value()) value_type(std::move(*entries[i].value()));
+					entries[i].value()->~value_type();
+				}
+			}
+			free(entries);
+			entries = tmp;
+			entryCapacity = cap;
+		}
+
+		// squeeze out dead entries and rebuild the index with room for len + extra entries
+		void rebuild(size_t extra)
+		{
+			size_t j = 0;
+			for (size_t i = 0; i < entryCount; ++i) {
+				if (!entries[i].alive) continue;
+				if (i != j) {
+					entries[j].hash = entries[i].hash;
+					entries[j].alive = true;
+					new(entries[j].value()) value_type(std::move(*entries[i].value()));
+					entries[i].value()->~value_type();
+					entries[i].alive = false;
+				}
+				++j;
+			}
+			entryCount = j;
+			free(groupMemory);
+			while ((len + extra) * 16 > capacity() * 7) groupCount *= 2;
+			newIndex();
+			for (size_t i = 0; i < entryCount; ++i) placeIndex(i);
+		}
+
+		template<class K>
+		size_t _find(const K &key) const
+		{
+			size_t h = mix(hash(key)), mask = groupMask(), g = (h >> 7) & mask;
+			for (size_t step = 0; ; g = (g + ++step) & mask) {
+				swiss_group grp(groups[g].ctrl);
+				for (unsigned m = grp.match(h2(h)); m; m &= m - 1) {
+					size_t e = groups[g].index[__builtin_ctz(m)];
+					if (entries[e].hash == h && equal(entries[e].value()->first, key)) return e;
+				}
+				if (grp.match_empty()) return NPOS;
+			}
+		}
+
+		// insert a value whose key is known to be absent, return its entry index
+		size_t _insert(const value_type &value)
+		{
+			if ((used + 1) * 8 > capacity() * 7 || (entryCount > len && (entryCount - len) * 100 >= entryCount * compactPercent))
+				rebuild(1);
+			if (entryCount == entryCapacity) growEntries();
+			size_t e = entryCount++;
+			entries[e].hash = mix(hash(value.first));
+			entries[e].alive = true;
+			new(entries[e].value()) value_type(value);
+			placeIndex(e);
+			++len;
+			return e;
+		}
+
+		void _erase(size_t e)
+		{
+			size_t slot = slotOf(e);
+			// a group with an empty slot was never full, no probe went past it
+			if (swiss_group(groups[slot / WIDTH].ctrl).match_empty()) {
+				ctrlOf(slot) = swiss_group::EMPTY;
+				--used;
+			}
+			else ctrlOf(slot) = swiss_group::DELETED;
+			entries[e].value()->~value_type();
+			entries[e].alive = false;
+			--len;
+		}
+
+		void destroyEntries()
+		{
+			for (size_t i = 0; i < entryCount; ++i)
+				if (entries[i].alive) entries[i].value()->~value_type();
+			entryCount = len = 0;
+		}
+
+		void copyFrom(const flat_linked_hashmap &other)
+		{
+			entries = nullptr;
+			entryCount = entryCapacity = len = 0;
+			groupCount = INITIAL_GROUPS;
+			while (other.len * 16 > capacity() * 7) groupCount *= 2;
+			newIndex();
+			for (size_t i = 0; i < other.entryCount; ++i) {
+				if (!other.entries[i].alive) continue;
+				if (entryCount == entryCapacity) growEntries();
+				entries[entryCount].hash = other.entries[i].hash;
+				entries[entryCount].alive = true;
+				new(entries[entryCount].value()) value_type(*other.entries[i].value());
+				placeIndex(entryCount++);
+				++len;
+			}
+		}
+
+		// positions of live entries around i, NPOS (the end() position) if there is none
+		size_t nextAlive(size_t i) const
+		{
+			while (i < entryCount && !entries[i].alive) ++i;
+			return i < entryCount ? i : NPOS;
+		}
+		size_t prevAlive(size_t i) const
+		{
+			if (i > entryCount) i = entryCount;
+			while (i > 0 && !entries[i - 1].alive) --i;
+			return i ? i - 1 : NPOS;
+		}
+
+	public:
+		class const_iterator;
+		class iterator {
+		private:
+			flat_linked_hashmap *id;
+			size_t pos;
+		public:
+			explicit iterator(flat_linked_hashmap *_id = nullptr, size_t _pos = 0): id(_id), pos(_pos) {}
+			iterator(const iterator &other) = default;
+
+			flat_linked_hashmap *getid() const {return id;}
+			size_t getpos() const {return pos;}
+
+			iterator operator++(int) {
+				iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+			iterator & operator++() {
+				if (id == nullptr || pos == NPOS)
+					throw invalid_iterator();
+				pos = id->nextAlive(pos + 1);
+				return *this;
+			}
+			iterator operator--(int) {
+				iterator tmp = *this;
+				--*this;
+				return tmp;
+			}
+			iterator & operator--() {
+				size_t p = id == nullptr ? NPOS : id->prevAlive(pos);
+				if (p == NPOS)
+					throw invalid_iterator();
+				pos = p;
+				return *this;
+			}
+			value_type & operator *() const {
+				if (id == nullptr || pos >= id->entryCount || !id->entries[pos].alive)
+					throw invalid_iterator();
+				return *id->entries[pos].value();
+			}
+			value_type * operator ->() const {
+				return &**this;
+			}
+
+			bool operator==(const iterator &rhs) const {return id == rhs.getid() && pos == rhs.getpos();}
+			bool operator==(const const_iterator &rhs) const {return id == rhs.getid() && pos == rhs.getpos();}
+			bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+			bool operator!=(const const_iterator &rhs) const {return !(*this == rhs);}
+		};
+		class const_iterator {
+		private:
+			const flat_linked_hashmap *id;
+			size_t pos;
+		public:
+			explicit const_iterator(const flat_linked_hashmap *_id = nullptr, size_t _pos = 0): id(_id), pos(_pos) {}
+			const_iterator(const const_iterator &other) = default;
+			const_iterator(const iterator &other): id(other.getid()), pos(other.getpos()) {}
+
+			const flat_linked_hashmap *getid() const {return id;}
+			size_t getpos() const {return pos;}
+
+			const_iterator operator++(int) {
+				const_iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+			const_iterator & operator++() {
+				if (id == nullptr || pos == NPOS)
+					throw invalid_iterator();
+				pos = id->nextAlive(pos + 1);
+				return *this;
+			}
+			const_iterator operator--(int) {
+				const_iterator tmp = *this;
+				--*this;
+				return tmp;
+			}
+			const_iterator & operator--() {
+				size_t p = id == nullptr ? NPOS : id->prevAlive(pos);
+				if (p == NPOS)
+					throw invalid_iterator();
+				pos = p;
+				return *this;
+			}
+			const value_type & operator *() const {
+				if (id == nullptr || pos >= id->entryCount || !id->entries[pos].alive)
+					throw invalid_iterator();
+				return *id->entries[pos].value();
+			}
+			const value_type * operator ->() const {
+				return &**this;
+			}
+
+			bool operator==(const iterator &rhs) const {return id == rhs.getid() && pos == rhs.getpos();}
+			bool operator==(const const_iterator &rhs) const {return id == rhs.getid() && pos == rhs.getpos();}
+			bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+			bool operator!=(const const_iterator &rhs) const {return !(*this == rhs);}
+		};
+
+		flat_linked_hashmap(): entries(nullptr), entryCount(0), entryCapacity(0), len(0), groupCount(INITIAL_GROUPS),
+			compactPercent(COMPACT_PERCENT)
+		{
+			newIndex();
+		}
+		flat_linked_hashmap(const flat_linked_hashmap &other): compactPercent(other.compactPercent), hash(other.hash), equal(other.equal)
+		{
+			copyFrom(other);
+		}
+		flat_linked_hashmap & operator=(const flat_linked_hashmap &other)
+		{
+			if (&other == this) return *this;
+			destroyEntries();
+			free(entries);
+			free(groupMemory);
+			compactPercent = other.compactPercent;
+			hash = other.hash;
+			equal = other.equal;
+			copyFrom(other);
+			return *this;
+		}
+		~flat_linked_hashmap()
+		{
+			destroyEntries();
+			free(entries);
+			free(groupMemory);
+		}
+
+		/**
+		 * access specified element with bounds checking, throw index_out_of_bound if it does not exist.
+		 */
+		T & at(const Key &key)
+		{
+			size_t e = _find(key);
+			if (e == NPOS)
+				throw index_out_of_bound();
+			return entries[e].value()->second;
+		}
+		const T & at(const Key &key) const
+		{
+			size_t e = _find(key);
+			if (e == NPOS)
+				throw index_out_of_bound();
+			return entries[e].value()->second;
+		}
+		// at() by any key type, if Hash and Equal are transparent
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, T &>::type at(const K &key)
+		{
+			size_t e = _find(key);
+			if (e == NPOS)
+				throw index_out_of_bound();
+			return entries[e].value()->second;
+		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, const T &>::type at(const K &key) const
+		{
+			size_t e = _find(key);
+			if (e == NPOS)
+				throw index_out_of_bound();
+			return entries[e].value()->second;
+		}
+
+		/**
+		 * access specified element, performing an insertion if such key does not already exist.
+		 */
+		T & operator[](const Key &key)
+		{
+			size_t e = _find(key);
+			if (e == NPOS)
+				e = _insert(value_type(key, T()));
+			return entries[e].value()->second;
+		}
+		const T & operator[](const Key &key) const
+		{
+			return at(key);
+		}
+
+		iterator begin() {return iterator(this, nextAlive(0));}
+		const_iterator cbegin() const {return const_iterator(this, nextAlive(0));}
+		iterator end() {return iterator(this, NPOS);}
+		const_iterator cend() const {return const_iterator(this, NPOS);}
+
+		bool empty() const {return !len;}
+		size_t size() const {return len;}
+
+		/**
+		 * the number of erased entries still occupying the entry array.
+		 */
+		size_t tombstones() const {return entryCount - len;}
+
+		/**
+		 * drop every tombstone now, invalidates iterators.
+		 */
+		void compact()
+		{
+			if (entryCount > len) rebuild(0);
+		}
+
+		/**
+		 * compact on insertion once tombstones reach percent of the entry array;
+		 * 0 compacts whenever there is a tombstone, above 100 never
+		 * compacts before the index itself has to be rebuilt.
+		 */
+		void set_compact_percent(size_t percent) {compactPercent = percent;}
+		size_t get_compact_percent() const {return compactPercent;}
+
+		void clear()
+		{
+			destroyEntries();
+			resetIndex();
+		}
+
+		/**
+		 * insert an element.
+		 * return a pair of the iterator to the new element (or the element that
+		 *   prevented the insertion) and whether the insertion took place.
+		 */
+		pair<iterator, bool> insert(const value_type &value)
+		{
+			size_t e = _find(value.first);
+			if (e != NPOS) return pair<iterator, bool>(iterator(this, e), false);
+			e = _insert(value);
+			return pair<iterator, bool>(iterator(this, e), true);
+		}
+
+		/**
+		 * erase the element at pos, throw invalid_iterator if pos is end() or belongs to another map.
+		 */
+		void erase(iterator pos)
+		{
+			if (pos.getid() != this || pos.getpos() >= entryCount || !entries[pos.getpos()].alive)
+				throw invalid_iterator();
+			_erase(pos.getpos());
+		}
+
+		size_t count(const Key &key) const
+		{
+			return _find(key) == NPOS ? 0 : 1;
+		}
+
+		iterator find(const Key &key)
+		{
+			size_t e = _find(key);
+			return e == NPOS ? end() : iterator(this, e);
+		}
+		const_iterator find(const Key &key) const
+		{
+			size_t e = _find(key);
+			return e == NPOS ? cend() : const_iterator(this, e);
+		}
+
+		// count() and find() by any key type, if Hash and Equal are transparent
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, size_t>::type count(const K &key) const
+		{
+			return _find(key) == NPOS ? 0 : 1;
+		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, iterator>::type find(const K &key)
+		{
+			size_t e = _find(key);
+			return e == NPOS ? end() : iterator(this, e);
+		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, const_iterator>::type find(const K &key) const
+		{
+			size_t e = _find(key);
+			return e == NPOS ? cend() : const_iterator(this, e);
+		}
+};
+
+}
+
+#endif
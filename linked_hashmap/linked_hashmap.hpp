@@ -7,6 +7,12 @@
 // only for std::equal_to<T> and std::hash<T>
 #include <functional>
 #include <cstddef>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 #include "utility.hpp"
 #include "exceptions.hpp"
 
@@ -29,6 +35,13 @@ protected:
 
     node *head, *tail;
     size_t len;
+    // storage of head and tail, never constructed, so an empty list allocates nothing
+    alignas(node) unsigned char sentinels[2 * sizeof(node)];
+
+    void initsentinels() {
+        head = (node *) sentinels;
+        tail = (node *) (sentinels + sizeof(node));
+    }
 
     void freespace() {
         node* p = head->nex, *q;
@@ -196,8 +209,7 @@ public:
 
     list() {
         len = 0;
-        head = (node *) malloc(sizeof(node));
-        tail = (node *) malloc(sizeof(node));
+        initsentinels();
         head->nex = tail;
         head->pre = nullptr;
         tail->pre = head;
@@ -205,8 +217,7 @@ public:
     }
     list(const list &other) {
         len = other.len;
-        head = (node *) malloc(sizeof(node));
-        tail = (node *) malloc(sizeof(node));
+        initsentinels();
         node* p = other.head->nex, *q = head;
         while(p != other.tail) {
             q->nex = new node(p->data, q, tail);
@@ -221,8 +232,6 @@ public:
     virtual ~list() {
         freespace();
         head->nex = tail->pre = nullptr;
-        free(head);
-        free(tail);
     }
     list &operator=(const list &other) {
         if (&other == this) return *this;
@@ -234,6 +243,7 @@ public:
             q = q->nex;
             p = p->nex;
         }
+        if (q == head) head->nex = tail;
         tail->pre = q;
         head->pre = nullptr;
         tail->nex = nullptr;
@@ -371,77 +381,361 @@ class hash_node_t {
 	public:
 	T data;
 	hash_node_t *pre, *nex, *hash_nex;
+	// the pointer which points at this node: a bucket, or hash_nex of the node before it
+	hash_node_t **hash_pre;
+	// hash of data.first, so rehashing never calls the user hash again
+	size_t hash_code;
 
 	hash_node_t(const T &value, hash_node_t *_pre = nullptr, hash_node_t *_nex = nullptr, hash_node_t *_hash_nex = nullptr): 
-		data(value), pre(_pre), nex(_nex), hash_nex(_hash_nex) {}
+		data(value), pre(_pre), nex(_nex), hash_nex(_hash_nex), hash_pre(nullptr), hash_code(0) {}
 
 	hash_node_t(T &&value):
-		data(value), pre(nullptr), nex(nullptr), hash_nex(nullptr) {}
+		data(std::move(value)), pre(nullptr), nex(nullptr), hash_nex(nullptr), hash_pre(nullptr), hash_code(0) {}
+
+	// data constructed in place from args
+	struct emplace_tag {};
+	template<class... Args>
+	hash_node_t(emplace_tag, Args&&... args):
+		data(std::forward<Args>(args)...), pre(nullptr), nex(nullptr), hash_nex(nullptr), hash_pre(nullptr), hash_code(0) {}
+};
+
+/**
+ * how linked_hashmap maps a hash to a bucket and grows its table.
+ *
+ * prime_mod_policy keeps odd capacities (131, 265, ...) and takes the
+ * hash modulo the capacity, which costs a division per operation but
+ * copes with any hash. the power-of-two policies replace the division
+ * with a mask or a shift, after mixing the hash so that identity hashes
+ * such as std::hash<int> on sequential keys still spread over all
+ * buckets instead of using only the low bits.
+ */
+struct prime_mod_policy {
+	static const size_t INITIAL_CAPACITY = 131;
+	static size_t grow(size_t capacity) {return capacity * 2 + 3;}
+	static size_t index(size_t h, size_t capacity) {return h % capacity;}
+};
+
+// multiply by 2^64 / golden ratio and keep the top log2(capacity) bits
+struct pow2_fibonacci_policy {
+	static const size_t INITIAL_CAPACITY = 128;
+	static size_t grow(size_t capacity) {return capacity * 2;}
+	static size_t index(size_t h, size_t capacity) {
+		return (size_t)(((unsigned long long)h * 0x9e3779b97f4a7c15ULL) >> (64 - __builtin_ctzll(capacity)));
+	}
+};
+
+// murmur3 finalizer, then mask the low bits
+struct pow2_murmur_policy {
+	static const size_t INITIAL_CAPACITY = 128;
+	static size_t grow(size_t capacity) {return capacity * 2;}
+	static size_t index(size_t h, size_t capacity) {
+		unsigned long long x = h;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return (size_t)x & (capacity - 1);
+	}
 };
 
 template<
 	class Key,
 	class T,
 	class Hash = std::hash<Key>, 
-	class Equal = std::equal_to<Key>> 
+	class Equal = std::equal_to<Key>,
+	class IndexPolicy = prime_mod_policy> 
 class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Key, T>>> {
 	public:
 		using value_type = pair<const Key, T>;
 		using hash_node = hash_node_t<value_type>;
 		using list_hash = list<value_type, hash_node>;
 
-	private: 
-		static const size_t LOAD = 75, INITIAL_CAPACITY = 131;
+	protected:
+		// buckets moved from the old table per insert or erase while rehashing, and how many
+		// old buckets ahead of the move the next ones are fetched
+		static const size_t LOAD = 75, INITIAL_CAPACITY = IndexPolicy::INITIAL_CAPACITY, REHASH_STEP = 16,
+			REHASH_AHEAD = 4 * REHASH_STEP;
+		// how many keys ahead find_batch and count_batch fetch head nodes, and twice that for buckets
+		static const size_t BATCH_WIDTH = 16;
+		// up to this many elements there is no table, lookups scan the list
+		static const size_t SMALL_SIZE = 8;
 		hash_node** hashmap;
 		size_t capacity;
+		// max_load_factor and min_load_factor in percent, 0 never shrinks
+		size_t loadPercent, shrinkPercent;
+		// the table being drained during an incremental rehash, its buckets below rehashidx are empty
+		hash_node** oldmap;
+		size_t old_capacity, rehashidx;
 		Hash hash;
 		Equal equal;
 
 		//new a hashmap, base on current capacity
+		//calloc leaves zeroing a large table to the kernel, so a new table costs no eager O(capacity) pass
 		void _new_hashmap()
 		{
-			hashmap	= new hash_node * [capacity];
-			std::fill(hashmap, hashmap + capacity, nullptr);
+			hashmap = (hash_node **) calloc(capacity, sizeof(hash_node *));
+			_advise_huge_pages(hashmap, capacity * sizeof(hash_node *));
+		}
+
+		// the kernel faults a calloc'd table in on first touch, and an incremental rehash touches
+		// a new page every few hundred inserts; ask for huge pages on the whole 2 MiB pages of the
+		// table, so a large table faults in a few stalls instead of one per 4 KiB. only a hint
+		static void _advise_huge_pages(void *p, size_t bytes)
+		{
+#ifdef MADV_HUGEPAGE
+			const size_t HUGE_PAGE = 2 << 20;
+			size_t begin = ((size_t)p + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE, end = ((size_t)p + bytes) / HUGE_PAGE * HUGE_PAGE;
+			if (end > begin)
+				madvise((void *)begin, end - begin, MADV_HUGEPAGE);
+#else
+			(void)p;
+			(void)bytes;
+#endif
 		}
 
 		// rehash a hashmap, provided the original hashmap is already deleted
 		void _rehash()
 		{
 			_new_hashmap();
-			for (hash_node *p = this->head->nex; p != nullptr && p != this->tail; p = p->nex) {
-				size_t idx = hash(p->data.first) % capacity;
-				p->hash_nex = hashmap[idx];
-				hashmap[idx] = p;
-			}
+			for (hash_node *p = this->head->nex; p != nullptr && p != this->tail; p = p->nex)
+				_link_hash(&hashmap[IndexPolicy::index(p->hash_code, capacity)], p);
+		}
+
+		// push p in front of the chain starting at bucket
+		static void _link_hash(hash_node **bucket, hash_node *p)
+		{
+			p->hash_nex = *bucket;
+			if (*bucket != nullptr)
+				(*bucket)->hash_pre = &p->hash_nex;
+			*bucket = p;
+			p->hash_pre = bucket;
+		}
+
+		// remove p from its chain in O(1), whichever table it is in
+		static void _unlink_hash(hash_node *p)
+		{
+			*p->hash_pre = p->hash_nex;
+			if (p->hash_nex != nullptr)
+				p->hash_nex->hash_pre = p->hash_pre;
 		}
 
-		// find a value base on a key, return a pointer to the node
-		hash_node *_find(const Key& key) const
+		// find a value base on a key, or anything hash and equal take for one, return a pointer to the node
+		template<class K>
+		hash_node *_find(const K& key) const
+		{
+			return _find(key, hash(key));
+		}
+		// the same, with the hash of key already at hand
+		template<class K>
+		hash_node *_find(const K& key, size_t h) const
 		{
-			size_t idx = hash(key) % capacity;
-            hash_node* p = hashmap[idx];
-			while (p!= nullptr && !equal(p->data.first, key))
+			if (hashmap == nullptr) {
+				hash_node *p = this->head->nex;
+				while (p != this->tail && (p->hash_code != h || !equal(p->data.first, key)))
+					p = p->nex;
+				return p == this->tail ? nullptr : p;
+			}
+			hash_node *p = *_bucket(h);
+			// different hashes never hold equal keys, skip them without calling equal
+			while (p!= nullptr && (p->hash_code != h || !equal(p->data.first, key)))
 				p = p->hash_nex;
 			return p;
 		}
 
-		// double size the hashmap
+		// look up keys[0 .. n) as a pipeline, calling f(i, node of keys[i] or nullptr) in order:
+		// while key i is resolved, the head node of key i + BATCH_WIDTH and the bucket of
+		// key i + 2 * BATCH_WIDTH are being fetched, so the cache misses of many keys overlap
+		template<class F>
+		void _find_batch(const Key *keys, size_t n, F f) const
+		{
+			if (hashmap == nullptr) {
+				for (size_t i = 0; i < n; ++i)
+					f(i, _find(keys[i]));
+				return;
+			}
+			const size_t RING = 2 * BATCH_WIDTH;
+			size_t h[RING];
+			hash_node **bucket[RING];
+			hash_node *head[RING];
+			for (size_t i = 0; i < n + RING; ++i) {
+				if (i >= RING) {
+					size_t k = i - RING, r = k % RING;
+					hash_node *p = head[r];
+					while (p!= nullptr && (p->hash_code != h[r] || !equal(p->data.first, keys[k])))
+						p = p->hash_nex;
+					f(k, p);
+				}
+				if (i >= BATCH_WIDTH && i - BATCH_WIDTH < n) {
+					size_t r = (i - BATCH_WIDTH) % RING;
+					head[r] = *bucket[r];
+					__builtin_prefetch(head[r]);
+				}
+				if (i < n) {
+					size_t r = i % RING;
+					h[r] = hash(keys[i]);
+					bucket[r] = _bucket(h[r]);
+					__builtin_prefetch(bucket[r]);
+				}
+			}
+		}
+
+		// the chain of hash h: its old bucket until that bucket has moved, then its new one.
+		// new keys follow the same rule, so a lookup never has to search both tables
+		hash_node **_bucket(size_t h) const
+		{
+			if (oldmap != nullptr) {
+				size_t old_idx = IndexPolicy::index(h, old_capacity);
+				if (old_idx >= rehashidx) return &oldmap[old_idx];
+			}
+			return &hashmap[IndexPolicy::index(h, capacity)];
+		}
+
+		// move up to n non-empty buckets of the old table into the new one, as the redis dict does;
+		// at most 10 * n empty buckets are skipped per call to bound its cost.
+		// the moved nodes lie all over memory, so their cache misses are overlapped: a batch of
+		// REHASH_STEP heads first fetches all their new buckets, then the chains in those, then
+		// links; and the heads of the next old buckets, and their new buckets, are fetched ahead
+		void _rehash_step(size_t n)
+		{
+			size_t empty_visits = n * 10;
+			while (n > 0 && empty_visits > 0 && rehashidx < old_capacity) {
+				hash_node *first[REHASH_STEP], **to[REHASH_STEP];
+				size_t k = 0;
+				while (k < REHASH_STEP && k < n && rehashidx < old_capacity) {
+					hash_node *p = oldmap[rehashidx];
+					if (p == nullptr) {
+						++rehashidx;
+						if (--empty_visits == 0) break;
+						continue;
+					}
+					first[k++] = p;
+					oldmap[rehashidx++] = nullptr;
+				}
+				for (size_t i = 0; i < k; ++i) {
+					to[i] = &hashmap[IndexPolicy::index(first[i]->hash_code, capacity)];
+					__builtin_prefetch(to[i], 1);
+				}
+				for (size_t i = 0; i < k; ++i)
+					if (*to[i] != nullptr) __builtin_prefetch(*to[i], 1);
+				for (size_t i = 0; i < k; ++i) {
+					hash_node *p = first[i], *q = p->hash_nex;
+					_link_hash(to[i], p);
+					for (p = q; p != nullptr; p = q) {
+						q = p->hash_nex;
+						_link_hash(&hashmap[IndexPolicy::index(p->hash_code, capacity)], p);
+					}
+				}
+				n -= k;
+			}
+			if (rehashidx == old_capacity) {
+				free(oldmap);
+				oldmap = nullptr;
+				return;
+			}
+			// the heads of the nearer half were fetched by the last call, fetch their new buckets
+			size_t half = rehashidx + REHASH_AHEAD / 2, end = rehashidx + REHASH_AHEAD;
+			if (half > old_capacity) half = old_capacity;
+			if (end > old_capacity) end = old_capacity;
+			for (size_t i = rehashidx; i < half; ++i)
+				if (oldmap[i] != nullptr)
+					__builtin_prefetch(&hashmap[IndexPolicy::index(oldmap[i]->hash_code, capacity)], 1);
+			for (size_t i = half; i < end; ++i)
+				if (oldmap[i] != nullptr)
+					__builtin_prefetch(oldmap[i], 1);
+		}
+
+		// the list copies only the data of the nodes, copy their hash codes as well
+		void _copy_hash_code(const linked_hashmap &other)
+		{
+			hash_node *q = this->head->nex;
+			for (hash_node *p = other.head->nex; p != other.tail; p = p->nex, q = q->nex)
+				q->hash_code = p->hash_code;
+		}
+
+		// double size the hashmap, the nodes move over in later calls of _rehash_step
 		void _double_size()
 		{
-			delete [] hashmap;
-			capacity = capacity * 2 + 3;
+			if (oldmap != nullptr)
+				_rehash_step(old_capacity);
+			oldmap = hashmap;
+			old_capacity = capacity;
+			rehashidx = 0;
+			capacity = IndexPolicy::grow(capacity);
+			_new_hashmap();
+		}
+
+		// the smallest capacity the policy grows to which holds n elements and has at least buckets buckets
+		size_t _capacity_for(size_t n, size_t buckets) const
+		{
+			size_t c = INITIAL_CAPACITY;
+			while (c < buckets || n * 100 > c * loadPercent)
+				c = IndexPolicy::grow(c);
+			return c;
+		}
+
+		// rebuild the table at capacity c at once, finishing any incremental rehash
+		void _resize(size_t c)
+		{
+			_delete_hashmap();
+			capacity = c;
 			_rehash();
 		}
 
+		// after an erase, shrink if the load has fallen under min_load_factor; never above
+		// a quarter of max_load_factor, so a shrunk map is not about to grow again
+		void _shrink()
+		{
+			size_t limit = shrinkPercent < loadPercent / 4 ? shrinkPercent : loadPercent / 4;
+			if (this->len * 100 >= capacity * limit) return;
+			size_t c = _capacity_for(this->len, 0);
+			if (c < capacity) _resize(c);
+		}
+
+		void _delete_hashmap()
+		{
+			free(hashmap);
+			free(oldmap);
+			hashmap = oldmap = nullptr;
+		}
+
 		// insert a node with a given key, provided we know that the key do not exist!
 		hash_node *_insert(const value_type& value)
 		{
-			if (this->len * 100 > capacity * LOAD)
+			return _emplace(hash(value.first), value);
+		}
+		hash_node *_insert(value_type&& value)
+		{
+			size_t h = hash(value.first);
+			return _emplace(h, std::move(value));
+		}
+
+		// construct a node from args in place and insert it, its key hashes to h and does not exist
+		template<class... Args>
+		hash_node *_emplace(size_t h, Args&&... args)
+		{
+			return _link(new hash_node(typename hash_node::emplace_tag(), std::forward<Args>(args)...), h);
+		}
+
+		// insert a new node whose key hashes to h
+		hash_node *_link(hash_node *p, size_t h)
+		{
+			if (hashmap == nullptr) {
+				if (this->len < SMALL_SIZE) {
+					p->hash_code = h;
+					this->privateinsert(this->tail, p);
+					return p;
+				}
+				// outgrowing the list scan, hash everything into a table of the current capacity
+				_rehash();
+			}
+			if (oldmap != nullptr)
+				_rehash_step(REHASH_STEP);
+			if (this->len * 100 > capacity * loadPercent)
 				_double_size();
-			size_t idx = hash(value.first) % capacity;
-			hash_node *p = new hash_node(value);
+			p->hash_code = h;
 			this->privateinsert(this->tail, p);
-			p->hash_nex = hashmap[idx], hashmap[idx] = p;
+			_link_hash(_bucket(h), p);
 			return p;
 		}
 
@@ -450,13 +744,14 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		using iterator = typename list_hash::iterator;
 		using const_iterator = typename list_hash::const_iterator;
 		
-		linked_hashmap(): list_hash::list(), capacity(INITIAL_CAPACITY) 
-		{
-			_new_hashmap();
-		}
+		// no table until the map holds more than SMALL_SIZE elements
+		linked_hashmap(): list_hash::list(), hashmap(nullptr), capacity(INITIAL_CAPACITY), loadPercent(LOAD), shrinkPercent(0), oldmap(nullptr) {}
 
-		linked_hashmap(const linked_hashmap &other): list_hash::list(other), capacity(other.capacity) {
-			_rehash();
+		linked_hashmap(const linked_hashmap &other): list_hash::list(other), hashmap(nullptr), capacity(other.capacity),
+			loadPercent(other.loadPercent), shrinkPercent(other.shrinkPercent), oldmap(nullptr) {
+			_copy_hash_code(other);
+			if (other.hashmap != nullptr)
+				_rehash();
 		}
 	
 		// assignment operator using the list's assignment operator
@@ -464,9 +759,13 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		{
 			if (&other == this) return *this;
 			list_hash::operator=(other);
-			delete [] hashmap;
+			_copy_hash_code(other);
+			_delete_hashmap();
 			capacity = other.capacity;
-			_rehash();
+			loadPercent = other.loadPercent;
+			shrinkPercent = other.shrinkPercent;
+			if (other.hashmap != nullptr)
+				_rehash();
 			return *this;
 		}
 	
@@ -475,7 +774,7 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		 */
 		~linked_hashmap() 
 		{
-			delete [] hashmap;
+			_delete_hashmap();
 		}
 	
 		/**
@@ -498,6 +797,23 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 				throw index_out_of_bound();
 			return target->data.second;
 		}
+		// at() by any key type, if Hash and Equal are transparent
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, T &>::type at(const K &key)
+		{
+			hash_node* target = _find(key);
+			if (!target)
+				throw index_out_of_bound();
+			return target->data.second;
+		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, const T &>::type at(const K &key) const
+		{
+			hash_node* target = _find(key);
+			if (!target)
+				throw index_out_of_bound();
+			return target->data.second;
+		}
 	
 		/**
 		 * TODO
@@ -507,10 +823,11 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		 */
 		T & operator[](const Key &key) 
 		{
-			hash_node *target = _find(key);
-			if (target)
-				return target->data.second;
-			return _insert(pair<Key, T>(key, T()))->data.second;
+			return try_emplace(key).first->second;
+		}
+		T & operator[](Key &&key)
+		{
+			return try_emplace(std::move(key)).first->second;
 		}
 	
 		/**
@@ -524,7 +841,64 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		void clear()
 		{
 			list_hash::clear();
-			std::fill(hashmap, hashmap + capacity, nullptr);
+			if (shrinkPercent) {
+				// back to no table at all
+				_delete_hashmap();
+				capacity = INITIAL_CAPACITY;
+				return;
+			}
+			if (hashmap != nullptr)
+				std::fill(hashmap, hashmap + capacity, nullptr);
+			free(oldmap);
+			oldmap = nullptr;
+		}
+
+		/**
+		 * make room for n elements, so that inserting up to n never grows the table.
+		 */
+		void reserve(size_t n)
+		{
+			size_t c = _capacity_for(n > this->len ? n : this->len, 0);
+			if (c > capacity || (hashmap == nullptr && n > SMALL_SIZE)) _resize(c);
+		}
+
+		/**
+		 * rebuild the table with at least buckets buckets, and enough for size()
+		 * elements under max_load_factor(). rehash(0) shrinks the table to fit.
+		 */
+		void rehash(size_t buckets)
+		{
+			size_t c = _capacity_for(this->len, buckets);
+			if (c != capacity || oldmap != nullptr || (hashmap == nullptr && buckets)) _resize(c);
+		}
+
+		// 0 while the map is small enough to have no table
+		size_t bucket_count() const {return hashmap ? capacity : 0;}
+		float load_factor() const {return hashmap ? (float)this->len / capacity : 0;}
+
+		/**
+		 * the load at which the table doubles, 0.75 by default. a lower value
+		 * grows the table at once if it is over it. throw runtime_error unless positive.
+		 */
+		float max_load_factor() const {return loadPercent / 100.0f;}
+		void max_load_factor(float ml)
+		{
+			if (!(ml > 0))
+				throw runtime_error();
+			loadPercent = (size_t)(ml * 100 + 0.5f);
+			if (loadPercent == 0) loadPercent = 1;
+			if (this->len * 100 > capacity * loadPercent) rehash(0);
+		}
+
+		/**
+		 * the load under which erase() shrinks the table to fit, and clear()
+		 * frees it; 0, the default, never shrinks. it
+		 * acts as at most a quarter of max_load_factor.
+		 */
+		float min_load_factor() const {return shrinkPercent / 100.0f;}
+		void min_load_factor(float ml)
+		{
+			shrinkPercent = ml > 0 ? (size_t)(ml * 100 + 0.5f) : 0;
 		}
 	
 		/**
@@ -535,9 +909,87 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		 */
 		pair<iterator, bool> insert(const value_type &value)
 		{
-			hash_node* p = _find(value.first);
+			size_t h = hash(value.first);
+			hash_node* p = _find(value.first, h);
+			if (p) return pair<iterator, bool> (iterator(p, this), 0);
+			p = _emplace(h, value);
+			return pair<iterator, bool> (iterator(p, this), 1);
+		}
+		pair<iterator, bool> insert(value_type &&value)
+		{
+			size_t h = hash(value.first);
+			hash_node* p = _find(value.first, h);
+			if (p) return pair<iterator, bool> (iterator(p, this), 0);
+			p = _emplace(h, std::move(value));
+			return pair<iterator, bool> (iterator(p, this), 1);
+		}
+
+		/**
+		 * construct an element from args in place and insert it unless its key
+		 * exists, in which case the element is destroyed again. return as insert().
+		 */
+		template<class... Args>
+		pair<iterator, bool> emplace(Args&&... args)
+		{
+			hash_node *p = new hash_node(typename hash_node::emplace_tag(), std::forward<Args>(args)...);
+			size_t h = hash(p->data.first);
+			hash_node *q = _find(p->data.first, h);
+			if (q) {
+				delete p;
+				return pair<iterator, bool> (iterator(q, this), 0);
+			}
+			return pair<iterator, bool> (iterator(_link(p, h), this), 1);
+		}
+
+		/**
+		 * insert key with a value constructed in place from args, unless key
+		 * exists; then args are left untouched. return as insert().
+		 */
+		template<class... Args>
+		pair<iterator, bool> try_emplace(const Key &key, Args&&... args)
+		{
+			size_t h = hash(key);
+			hash_node *p = _find(key, h);
+			if (p) return pair<iterator, bool> (iterator(p, this), 0);
+			p = _emplace(h, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			return pair<iterator, bool> (iterator(p, this), 1);
+		}
+		template<class... Args>
+		pair<iterator, bool> try_emplace(Key &&key, Args&&... args)
+		{
+			size_t h = hash(key);
+			hash_node *p = _find(key, h);
 			if (p) return pair<iterator, bool> (iterator(p, this), 0);
-			p = _insert(value);
+			p = _emplace(h, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			return pair<iterator, bool> (iterator(p, this), 1);
+		}
+
+		/**
+		 * assign value to key, inserting key if it does not exist.
+		 * return the iterator to the element and whether it was inserted.
+		 */
+		template<class M>
+		pair<iterator, bool> insert_or_assign(const Key &key, M &&value)
+		{
+			size_t h = hash(key);
+			hash_node *p = _find(key, h);
+			if (p) {
+				p->data.second = std::forward<M>(value);
+				return pair<iterator, bool> (iterator(p, this), 0);
+			}
+			p = _emplace(h, key, std::forward<M>(value));
+			return pair<iterator, bool> (iterator(p, this), 1);
+		}
+		template<class M>
+		pair<iterator, bool> insert_or_assign(Key &&key, M &&value)
+		{
+			size_t h = hash(key);
+			hash_node *p = _find(key, h);
+			if (p) {
+				p->data.second = std::forward<M>(value);
+				return pair<iterator, bool> (iterator(p, this), 0);
+			}
+			p = _emplace(h, std::move(key), std::forward<M>(value));
 			return pair<iterator, bool> (iterator(p, this), 1);
 		}
 	
@@ -550,20 +1002,14 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 		{
 			if (pos.getpos() == this->head || pos.getid() != this  || pos == this->end())
             	throw invalid_iterator();
-			hash_node* p = _find(pos.getpos()->data.first);
-			size_t idx = hash(p->data.first) % capacity;
-			if (p == nullptr || hashmap[idx] == nullptr)
-				throw index_out_of_bound();
-			if (hashmap[idx] == p) {
-				hashmap[idx] = p->hash_nex;
-				list_hash::erase(iterator(p, this));
-			}
-			else {
-				hash_node *q = hashmap[idx];
-				for (; !equal(q->hash_nex->data.first, p->data.first); q = q->hash_nex);
-				q->hash_nex = p->hash_nex;
-				list_hash::erase(iterator(p, this));
-			}
+			hash_node* p = pos.getpos();
+			if (oldmap != nullptr)
+				_rehash_step(REHASH_STEP);
+			if (hashmap != nullptr)
+				_unlink_hash(p);
+			list_hash::erase(iterator(p, this));
+			if (shrinkPercent)
+				_shrink();
 		}
 	
 		/**
@@ -578,6 +1024,11 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 			if (!p) return 0;
 			else return 1;
 		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, size_t>::type count(const K &key) const
+		{
+			return _find(key) ? 1 : 0;
+		}
 	
 		/**
 		 * Finds an element with key equivalent to key.
@@ -597,6 +1048,52 @@ class linked_hashmap : public list<pair<const Key, T>, hash_node_t<pair<const Ke
 			if (!p) return this->cend();
 			return const_iterator(p, this);
 		}
+		/**
+		 * find() for keys[0 .. n), into out[0 .. n). faster than n calls of
+		 * find() when the table does not fit in the cache.
+		 */
+		void find_batch(const Key *keys, size_t n, iterator *out)
+		{
+			_find_batch(keys, n, [&](size_t i, hash_node *p) {
+				out[i] = p ? iterator(p, this) : this->end();
+			});
+		}
+		void find_batch(const Key *keys, size_t n, const_iterator *out) const
+		{
+			_find_batch(keys, n, [&](size_t i, hash_node *p) {
+				out[i] = p ? const_iterator(p, this) : this->cend();
+			});
+		}
+
+		/**
+		 * count() for keys[0 .. n), into out[0 .. n) unless out is nullptr.
+		 * return how many of the keys exist.
+		 */
+		size_t count_batch(const Key *keys, size_t n, size_t *out = nullptr) const
+		{
+			size_t total = 0;
+			_find_batch(keys, n, [&](size_t i, hash_node *p) {
+				total += p != nullptr;
+				if (out) out[i] = p != nullptr;
+			});
+			return total;
+		}
+
+		// find() by any key type, if Hash and Equal are transparent
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, iterator>::type find(const K &key)
+		{
+			hash_node *p = _find(key);
+			if (!p) return this->end();
+			return iterator(p, this);
+		}
+		template<class K>
+		typename transparent_lookup<Hash, Equal, K, const_iterator>::type find(const K &key) const
+		{
+			hash_node *p = _find(key);
+			if (!p) return this->cend();
+			return const_iterator(p, this);
+		}
 };
 
 }
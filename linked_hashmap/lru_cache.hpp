@@ -0,0 +1,193 @@
+/**
+ * a least recently used cache on top of linked_hashmap
+ */
+#ifndef SJTU_LRU_CACHE_HPP
+#define SJTU_LRU_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+
+/**
+ * hits and misses of get() on a cache.
+ */
+struct cache_stats {
+	size_t hits, misses;
+
+	cache_stats(): hits(0), misses(0) {}
+	double hit_ratio() const {return hits + misses ? (double)hits / (hits + misses) : 0;}
+};
+
+/**
+ * the default weight of a cache entry, in bytes: the size of the pair itself.
+ * pass a weigher of your own to count memory owned by the key or value.
+ */
+template<class Key, class T>
+struct entry_size {
+	size_t operator()(const Key &, const T &) const {return sizeof(pair<const Key, T>);}
+};
+
+/**
+ * the list order of linked_hashmap doubles as the recency order: the
+ * front is the least recently used entry, the back the most recent one.
+ * get() and put() move a node to the back by relinking it in the list,
+ * the hash chains are not touched, so a hit costs one lookup and four
+ * pointer writes.
+ *
+ * the cache holds at most max_size entries whose weights add up to at
+ * most max_bytes, 0 means no limit. when a put() exceeds either bound,
+ * entries are evicted from the front, and the eviction callback sees
+ * every one of them just before it is destroyed. the callback must not
+ * modify the cache.
+ *
+ * values are only handed out as const, so the weight of an entry cannot
+ * change behind the back of the cache; use put() to replace a value.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Weigher = entry_size<Key, T>>
+class lru_cache : private linked_hashmap<Key, T, Hash, Equal> {
+	public:
+		using map_type = linked_hashmap<Key, T, Hash, Equal>;
+		using value_type = typename map_type::value_type;
+		using const_iterator = typename map_type::const_iterator;
+		using eviction_callback = std::function<void(const Key &, const T &)>;
+
+	private:
+		using hash_node = typename map_type::hash_node;
+
+		size_t max_entries, max_bytes, nowbytes;
+		cache_stats counter;
+		eviction_callback on_evict;
+		Weigher weigh;
+
+		// move p to the back, it becomes the most recently used entry
+		void _touch(hash_node *p)
+		{
+			if (p->nex != this->tail)
+				this->privateinsert(this->tail, this->privateerase(p));
+		}
+
+		void _remove(hash_node *p)
+		{
+			nowbytes -= weigh(p->data.first, p->data.second);
+			map_type::erase(typename map_type::iterator(p, this));
+		}
+
+		bool _over() const
+		{
+			return (max_entries && this->len > max_entries) || (max_bytes && nowbytes > max_bytes);
+		}
+
+		void _evict()
+		{
+			while (this->len && _over()) {
+				hash_node *p = this->head->nex;
+				if (on_evict) on_evict(p->data.first, p->data.second);
+				_remove(p);
+			}
+		}
+
+	public:
+		explicit lru_cache(size_t _max_size, size_t _max_bytes = 0, const Weigher &_weigh = Weigher()):
+			max_entries(_max_size), max_bytes(_max_bytes), nowbytes(0), weigh(_weigh) {}
+
+		/**
+		 * the value of key, which becomes the most recently used entry.
+		 * return nullptr if key is not cached.
+		 */
+		const T * get(const Key &key)
+		{
+			hash_node *p = this->_find(key);
+			if (!p) {
+				++counter.misses;
+				return nullptr;
+			}
+			++counter.hits;
+			_touch(p);
+			return &p->data.second;
+		}
+
+		/**
+		 * the value of key, without changing the recency order.
+		 * return nullptr if key is not cached.
+		 */
+		const T * peek(const Key &key) const
+		{
+			hash_node *p = this->_find(key);
+			return p ? &p->data.second : nullptr;
+		}
+
+		/**
+		 * cache value under key as the most recently used entry, replacing
+		 * an old value, then evict until the cache is within its bounds.
+		 * return true if key was not cached before.
+		 */
+		bool put(const Key &key, const T &value)
+		{
+			hash_node *p = this->_find(key);
+			bool inserted = !p;
+			if (p) {
+				nowbytes -= weigh(p->data.first, p->data.second);
+				p->data.second = value;
+				_touch(p);
+			}
+			else p = this->_insert(value_type(key, value));
+			nowbytes += weigh(p->data.first, p->data.second);
+			_evict();
+			return inserted;
+		}
+
+		/**
+		 * drop key without calling the eviction callback.
+		 * return false if key was not cached.
+		 */
+		bool erase(const Key &key)
+		{
+			hash_node *p = this->_find(key);
+			if (!p) return false;
+			_remove(p);
+			return true;
+		}
+
+		/**
+		 * change the bounds, evicting at once if the cache is over the new ones.
+		 */
+		void set_capacity(size_t _max_size, size_t _max_bytes = 0)
+		{
+			max_entries = _max_size;
+			max_bytes = _max_bytes;
+			_evict();
+		}
+		size_t max_size() const {return max_entries;}
+		size_t capacity() const {return max_entries;}
+		size_t max_byte_size() const {return max_bytes;}
+		size_t bytes() const {return nowbytes;}
+
+		void set_eviction_callback(const eviction_callback &callback) {on_evict = callback;}
+
+		const cache_stats & stats() const {return counter;}
+		void reset_stats() {counter = cache_stats();}
+
+		void clear()
+		{
+			map_type::clear();
+			nowbytes = 0;
+		}
+
+		using map_type::size;
+		using map_type::empty;
+		using map_type::count;
+		// from the least to the most recently used entry
+		using map_type::cbegin;
+		using map_type::cend;
+};
+
+}
+
+#endif
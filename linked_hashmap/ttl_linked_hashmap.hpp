@@ -0,0 +1,291 @@
+/**
+ * a linked_hashmap whose entries expire at a deadline
+ */
+#ifndef SJTU_TTL_LINKEDHASHMAP_HPP
+#define SJTU_TTL_LINKEDHASHMAP_HPP
+
+#include <cstddef>
+#include <functional>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+
+/**
+ * a mapped value together with the tick at which it expires.
+ */
+template<class T>
+struct expiring {
+	T value;
+	unsigned long long deadline;
+
+	expiring(const T &_value = T(), unsigned long long _deadline = 0): value(_value), deadline(_deadline) {}
+};
+
+/**
+ * every entry has a deadline in integer ticks, the clock only moves
+ * when the caller says so through advance() or expire(), like
+ * timer_wheel. an entry whose deadline is not later than now() is
+ * expired: find, at, count and operator[] treat it as absent, and the
+ * non-const ones erase it on the spot.
+ *
+ * put() and insert() place the entry at the back of the list, so while
+ * every deadline is at least the one before it (which uniform TTLs
+ * guarantee) the list is sorted by deadline and expire() erases from
+ * the front, O(1) per expired entry, stopping at the first live one.
+ * while some entry has a later deadline than the one after it,
+ * expire() instead examines entries round robin from where its last
+ * call stopped, at most max_items per call. the map counts such
+ * neighbours as entries come and go, so it is back on the sorted path
+ * as soon as the entries breaking the order are erased or moved.
+ *
+ * size() and iteration include expired entries which have not been
+ * erased yet; iteration yields pair<const Key, expiring<T>>.
+ */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>>
+class ttl_linked_hashmap : private linked_hashmap<Key, expiring<T>, Hash, Equal> {
+	public:
+		using time_type = unsigned long long;
+		using map_type = linked_hashmap<Key, expiring<T>, Hash, Equal>;
+		using value_type = typename map_type::value_type;
+		using iterator = typename map_type::iterator;
+		using const_iterator = typename map_type::const_iterator;
+
+		static const time_type NEVER = ~0ULL;
+
+	private:
+		using hash_node = typename map_type::hash_node;
+
+		time_type current, default_ttl;
+		// neighbours in the list whose deadlines decrease, the list is sorted by deadline when there is none
+		size_t inversions;
+		// where the next unordered sweep starts, nullptr for the front
+		hash_node *cursor;
+
+		time_type _deadline(time_type ttl) const
+		{
+			return ttl >= NEVER - current ? NEVER : current + ttl;
+		}
+
+		bool _expired(const hash_node *p) const
+		{
+			return p->data.second.deadline <= current;
+		}
+
+		// the live node of key, erasing it if it has expired
+		hash_node *_live(const Key &key)
+		{
+			hash_node *p = this->_find(key);
+			if (p && _expired(p)) {
+				_remove(p);
+				return nullptr;
+			}
+			return p;
+		}
+
+		void _remove(hash_node *p)
+		{
+			if (cursor == p) cursor = p->nex;
+			_unorder(p);
+			map_type::erase(iterator(p, this));
+			if (!this->len) cursor = nullptr;
+		}
+
+		bool _inverted(const hash_node *a, const hash_node *b) const
+		{
+			return a != this->head && b != this->tail && a->data.second.deadline > b->data.second.deadline;
+		}
+
+		// the entry at the back gets deadline
+		void _order(time_type deadline)
+		{
+			if (this->len && this->tail->pre->data.second.deadline > deadline)
+				++inversions;
+		}
+
+		// p is about to leave the list, its neighbours meet
+		void _unorder(hash_node *p)
+		{
+			inversions -= _inverted(p->pre, p) + _inverted(p, p->nex);
+			inversions += _inverted(p->pre, p->nex);
+		}
+
+	public:
+		explicit ttl_linked_hashmap(time_type _default_ttl = NEVER, time_type now = 0):
+			current(now), default_ttl(_default_ttl), inversions(0), cursor(nullptr) {}
+		ttl_linked_hashmap(const ttl_linked_hashmap &other):
+			map_type(other), current(other.current), default_ttl(other.default_ttl), inversions(other.inversions), cursor(nullptr) {}
+		ttl_linked_hashmap & operator=(const ttl_linked_hashmap &other)
+		{
+			if (&other == this) return *this;
+			map_type::operator=(other);
+			current = other.current;
+			default_ttl = other.default_ttl;
+			inversions = other.inversions;
+			cursor = nullptr;
+			return *this;
+		}
+
+		/**
+		 * move the clock to now, it never goes back.
+		 */
+		void advance(time_type now)
+		{
+			if (now > current) current = now;
+		}
+		time_type now() const {return current;}
+
+		/**
+		 * the value of key, throw index_out_of_bound if it does not exist or has expired.
+		 */
+		T & at(const Key &key)
+		{
+			hash_node *p = _live(key);
+			if (!p)
+				throw index_out_of_bound();
+			return p->data.second.value;
+		}
+		const T & at(const Key &key) const
+		{
+			hash_node *p = this->_find(key);
+			if (!p || _expired(p))
+				throw index_out_of_bound();
+			return p->data.second.value;
+		}
+
+		/**
+		 * the value of key, inserting T() with the default ttl if it does not exist or has expired.
+		 */
+		T & operator[](const Key &key)
+		{
+			hash_node *p = _live(key);
+			if (!p) {
+				time_type deadline = _deadline(default_ttl);
+				_order(deadline);
+				p = this->_insert(value_type(key, expiring<T>(T(), deadline)));
+			}
+			return p->data.second.value;
+		}
+
+		/**
+		 * insert key unless it is live, it expires ttl ticks from now().
+		 * return the iterator to the live entry and whether the insertion took place.
+		 */
+		pair<iterator, bool> insert(const Key &key, const T &value, time_type ttl)
+		{
+			hash_node *p = _live(key);
+			if (p) return pair<iterator, bool>(iterator(p, this), false);
+			time_type deadline = _deadline(ttl);
+			_order(deadline);
+			p = this->_insert(value_type(key, expiring<T>(value, deadline)));
+			return pair<iterator, bool>(iterator(p, this), true);
+		}
+		pair<iterator, bool> insert(const Key &key, const T &value)
+		{
+			return insert(key, value, default_ttl);
+		}
+
+		/**
+		 * set key to value, expiring ttl ticks from now(). a live key keeps
+		 * its node but moves to the back, as a new key would be.
+		 */
+		void put(const Key &key, const T &value, time_type ttl)
+		{
+			time_type deadline = _deadline(ttl);
+			hash_node *p = _live(key);
+			if (!p) {
+				_order(deadline);
+				this->_insert(value_type(key, expiring<T>(value, deadline)));
+				return;
+			}
+			if (cursor == p) cursor = p->nex;
+			_unorder(p);
+			this->privateerase(p);
+			_order(deadline);
+			this->privateinsert(this->tail, p);
+			p->data.second.value = value;
+			p->data.second.deadline = deadline;
+		}
+		void put(const Key &key, const T &value)
+		{
+			put(key, value, default_ttl);
+		}
+
+		size_t count(const Key &key) const
+		{
+			hash_node *p = this->_find(key);
+			return p && !_expired(p) ? 1 : 0;
+		}
+		iterator find(const Key &key)
+		{
+			hash_node *p = _live(key);
+			return p ? iterator(p, this) : this->end();
+		}
+		const_iterator find(const Key &key) const
+		{
+			hash_node *p = this->_find(key);
+			return p && !_expired(p) ? const_iterator(p, this) : this->cend();
+		}
+
+		/**
+		 * erase the element at pos, throw invalid_iterator if pos is end() or belongs to another map.
+		 */
+		void erase(iterator pos)
+		{
+			if (pos.getid() != this || pos == this->end() || pos.getpos() == this->head)
+				throw invalid_iterator();
+			_remove(pos.getpos());
+		}
+
+		/**
+		 * advance the clock to now and erase expired entries, examining at
+		 * most max_items of them (plus the first live one while the list is
+		 * sorted by deadline) and each at most once. return the number of
+		 * erased entries.
+		 */
+		size_t expire(time_type now, size_t max_items)
+		{
+			advance(now);
+			size_t erased = 0;
+			if (!inversions) {
+				while (erased < max_items && this->len && _expired(this->head->nex)) {
+					_remove(this->head->nex);
+					++erased;
+				}
+				return erased;
+			}
+			// never more than one pass over the list per call
+			size_t visits = max_items < this->len ? max_items : this->len;
+			for (; visits > 0 && this->len; --visits) {
+				if (cursor == nullptr || cursor == this->tail) cursor = this->head->nex;
+				hash_node *p = cursor;
+				cursor = p->nex;
+				if (_expired(p)) {
+					_remove(p);
+					++erased;
+				}
+			}
+			return erased;
+		}
+
+		void clear()
+		{
+			map_type::clear();
+			inversions = 0;
+			cursor = nullptr;
+		}
+
+		using map_type::size;
+		using map_type::empty;
+		using map_type::begin;
+		using map_type::end;
+		using map_type::cbegin;
+		using map_type::cend;
+};
+
+}
+
+#endif
@@ -1,10 +1,20 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include <cstddef>
+#include <tuple>
 #include <utility>
 
 namespace sjtu {
 
+// 0, 1, ..., N - 1 as a type, to expand a tuple into arguments
+template<size_t... I>
+struct index_list {};
+template<size_t N, size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+template<size_t... I>
+struct make_index_list<0, I...> {typedef index_list<I...> type;};
+
 template<class T1, class T2>
 class pair {
 public:
@@ -15,11 +25,36 @@ public:
 	pair(pair &&other) = default;
 	pair(const T1 &x, const T2 &y) : first(x), second(y) {}
 	template<class U1, class U2>
-	pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+	pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
 	template<class U1, class U2>
 	pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
 	template<class U1, class U2>
-	pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+	pair(pair<U1, U2> &&other) : first(std::forward<U1>(other.first)), second(std::forward<U2>(other.second)) {}
+	// first and second constructed in place from the elements of each tuple, as std::pair does
+	template<class... Args1, class... Args2>
+	pair(std::piecewise_construct_t, std::tuple<Args1...> x, std::tuple<Args2...> y) :
+		pair(x, y, typename make_index_list<sizeof...(Args1)>::type(), typename make_index_list<sizeof...(Args2)>::type()) {}
+
+private:
+	template<class... Args1, class... Args2, size_t... I1, size_t... I2>
+	pair(std::tuple<Args1...> &x, std::tuple<Args2...> &y, index_list<I1...>, index_list<I2...>) :
+		first(std::forward<Args1>(std::get<I1>(x))...), second(std::forward<Args2>(std::get<I2>(y))...) {}
+};
+
+template<class...>
+struct make_void {typedef void type;};
+
+/**
+ * type is R when both Hash and Equal declare is_transparent, as in c++20:
+ * they then accept any key type K they are written for, so lookups by K
+ * need not construct a Key. undefined otherwise, removing the overload.
+ */
+template<class Hash, class Equal, class K, class R, class = void>
+struct transparent_lookup {};
+template<class Hash, class Equal, class K, class R>
+struct transparent_lookup<Hash, Equal, K, R,
+	typename make_void<typename Hash::is_transparent, typename Equal::is_transparent>::type> {
+	typedef R type;
 };
 
 }
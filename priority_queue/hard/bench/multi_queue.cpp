@@ -0,0 +1,121 @@
+// throughput and rank error of multi_queue at 1-64 threads
+// build: g++ -std=c++17 -O2 -pthread -I.. multi_queue.cpp -o multi_queue
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "multi_queue.hpp"
+
+const int PREFILL = 1000000;
+const int OPS_PER_THREAD = 1000000;
+const int THREADS[] = {1, 2, 4, 8, 16, 32, 64};
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// a global mutex around priority_queue, the baseline we want to beat
+struct locked_queue {
+	std::mutex lock;
+	sjtu::priority_queue<int> heap;
+	void push(int x) {
+		std::lock_guard<std::mutex> guard(lock);
+		heap.push(x);
+	}
+	bool try_pop(int &out) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (heap.empty()) return false;
+		out = heap.top();
+		heap.pop();
+		return true;
+	}
+};
+
+template<class Queue>
+double throughput(Queue &q, int threads)
+{
+	for (int i = 0; i < PREFILL; ++i) q.push(nextRand() % PREFILL);
+	std::vector<std::thread> workers;
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; ++t)
+		workers.emplace_back([&q, t]() {
+			unsigned long long s = t * 7919 + 1;
+			int out;
+			for (int i = 0; i < OPS_PER_THREAD; ++i) {
+				s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+				if (s >> 63) q.push(s >> 40);
+				else q.try_pop(out);
+			}
+		});
+	for (auto &w : workers) w.join();
+	double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return 1.0 * threads * OPS_PER_THREAD / sec / 1e6;
+}
+
+// prefill a permutation of 0..PREFILL-1, pop everything concurrently while
+// tagging each pop with a global ticket, then replay the pops in ticket order
+// and measure how many better elements were still present at each pop.
+void rankError(int threads, double &mean, long long &worst)
+{
+	sjtu::multi_queue<int> q(threads);
+	std::vector<int> perm(PREFILL);
+	for (int i = 0; i < PREFILL; ++i) perm[i] = i;
+	for (int i = PREFILL - 1; i > 0; --i) std::swap(perm[i], perm[nextRand() % (i + 1)]);
+	for (int i = 0; i < PREFILL; ++i) q.push(perm[i]);
+
+	std::vector<int> order(PREFILL);
+	std::atomic<int> ticket(0);
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; ++t)
+		workers.emplace_back([&]() {
+			int out;
+			while (q.try_pop(out)) order[ticket.fetch_add(1)] = out;
+		});
+	for (auto &w : workers) w.join();
+
+	// fenwick tree over the values still in the queue
+	std::vector<int> bit(PREFILL + 1, 0);
+	for (int i = 1; i <= PREFILL; ++i) {
+		bit[i] += 1;
+		if (i + (i & -i) <= PREFILL) bit[i + (i & -i)] += bit[i];
+	}
+	long long total = 0;
+	worst = 0;
+	int remain = PREFILL;
+	for (int k = 0; k < ticket.load(); ++k) {
+		int v = order[k] + 1, below = 0;
+		for (int i = v; i; i -= i & -i) below += bit[i];
+		long long rank = remain - below;
+		total += rank;
+		worst = std::max(worst, rank);
+		for (int i = v; i <= PREFILL; i += i & -i) bit[i] -= 1;
+		--remain;
+	}
+	mean = 1.0 * total / PREFILL;
+}
+
+int main()
+{
+	printf("%8s %16s %16s %12s %12s\n", "threads", "locked Mops/s", "multi Mops/s", "mean rank", "max rank");
+	for (int threads : THREADS) {
+		locked_queue locked;
+		sjtu::multi_queue<int> multi(threads);
+		double a = throughput(locked, threads);
+		double b = throughput(multi, threads);
+		double mean;
+		long long worst;
+		rankError(threads, mean, worst);
+		printf("%8d %16.2f %16.2f %12.2f %12lld\n", threads, a, b, mean, worst);
+	}
+	return 0;
+}
@@ -0,0 +1,74 @@
+// comparisons and time spent by pop() with the top_down and bottom_up strategies
+// build: g++ -std=c++17 -O2 -I.. pop_strategy.cpp -o pop_strategy
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "priority_queue.hpp"
+
+const int N = 1000000;
+const int LIMBS = 2048;
+
+long long comparisons = 0;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+struct counting_less {
+	bool operator()(const int &a, const int &b) const {
+		++comparisons;
+		return a < b;
+	}
+};
+
+// a big integer compared limb by limb from the top, like Bint
+struct bint {
+	unsigned *limb;
+	bint(unsigned low = 0): limb(new unsigned[LIMBS]) {
+		memset(limb, 0, LIMBS * sizeof(unsigned));
+		limb[0] = low;
+	}
+	bint(const bint &other): limb(new unsigned[LIMBS]) {memcpy(limb, other.limb, LIMBS * sizeof(unsigned));}
+	bint &operator=(const bint &other) {
+		if (this != &other) memcpy(limb, other.limb, LIMBS * sizeof(unsigned));
+		return *this;
+	}
+	~bint() {delete [] limb;}
+};
+struct bint_less {
+	bool operator()(const bint &a, const bint &b) const {
+		++comparisons;
+		for (int i = LIMBS - 1; i >= 0; --i)
+			if (a.limb[i] != b.limb[i]) return a.limb[i] < b.limb[i];
+		return false;
+	}
+};
+
+template<class T, class Compare>
+void run(const char *name, int n, sjtu::pop_strategy s)
+{
+	sjtu::priority_queue<T, Compare> pq(s);
+	seed = 19260817;
+	for (int i = 0; i < n; ++i) pq.push(T(nextRand() % 1000000007));
+	comparisons = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (!pq.empty()) pq.pop();
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	printf("%-6s %-10s %10d pops %14lld comparisons %8.2f per pop %10.1f ms\n", name,
+		s == sjtu::pop_strategy::top_down ? "top_down" : "bottom_up", n, comparisons, 1.0 * comparisons / n, ms);
+}
+
+int main()
+{
+	run<int, counting_less>("int", N, sjtu::pop_strategy::top_down);
+	run<int, counting_less>("int", N, sjtu::pop_strategy::bottom_up);
+	run<bint, bint_less>("bint", N / 100, sjtu::pop_strategy::top_down);
+	run<bint, bint_less>("bint", N / 100, sjtu::pop_strategy::bottom_up);
+	return 0;
+}
@@ -0,0 +1,87 @@
+// push/pop and merge-heavy workloads for every storage policy of priority_queue
+// build: g++ -std=c++17 -O2 -I.. priority_queue_policy.cpp -o priority_queue_policy
+// one binary per engine and merge policy, so each is timed in its own build:
+// build: g++ -std=c++17 -O2 -I.. -DSTORAGE='dary_heap<4>' -DMERGE=merge_adaptive priority_queue_policy.cpp -o policy_4ary_adaptive
+// build: g++ -std=c++17 -O2 -I.. -DSTORAGE=pairing_heap priority_queue_policy.cpp -o policy_pairing
+// STORAGE is binary_heap, dary_heap<D>, pairing_heap or leftist_heap; MERGE is merge_rebuild
+// (the default), merge_insert or merge_adaptive. without STORAGE every pair is run
+#include <chrono>
+#include <cstdio>
+
+#include "priority_queue.hpp"
+
+const int N = 2000000;
+const int MERGES = 2000, MERGE_SIZE = 100;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+double elapsed(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<class Storage, class Merge>
+void run(const char *name, const char *merge)
+{
+	using queue = sjtu::priority_queue<int, std::less<int>, Storage, Merge>;
+	seed = 19260817;
+	long long sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		queue q;
+		for (int i = 0; i < N; ++i) q.push(nextRand() % 1000000007);
+		for (int i = 0; i < N; ++i) {
+			sum += q.top();
+			q.pop();
+		}
+	}
+	double pushPop = elapsed(start);
+
+	start = std::chrono::steady_clock::now();
+	{
+		queue q;
+		for (int m = 0; m < MERGES; ++m) {
+			queue other;
+			for (int i = 0; i < MERGE_SIZE; ++i) other.push(nextRand() % 1000000007);
+			q.merge(other);
+			sum += q.top();
+			q.pop();
+		}
+	}
+	double merges = elapsed(start);
+	printf("%-12s %-14s push+pop %9.1f ms   merges %9.1f ms   (%lld)\n", name, merge, pushPop, merges, sum % 1000);
+}
+
+#define NAME(x) #x
+#define STRING(x) NAME(x)
+
+int main()
+{
+#ifdef STORAGE
+#ifndef MERGE
+#define MERGE merge_rebuild
+#endif
+	run<sjtu::STORAGE, sjtu::MERGE>(STRING(STORAGE), STRING(MERGE));
+#else
+	run<sjtu::binary_heap, sjtu::merge_rebuild>("binary", "rebuild");
+	run<sjtu::binary_heap, sjtu::merge_insert>("binary", "insert");
+	run<sjtu::binary_heap, sjtu::merge_adaptive>("binary", "adaptive");
+	run<sjtu::dary_heap<4>, sjtu::merge_rebuild>("4ary", "rebuild");
+	run<sjtu::dary_heap<4>, sjtu::merge_insert>("4ary", "insert");
+	run<sjtu::dary_heap<4>, sjtu::merge_adaptive>("4ary", "adaptive");
+	run<sjtu::dary_heap<8>, sjtu::merge_rebuild>("8ary", "rebuild");
+	run<sjtu::dary_heap<8>, sjtu::merge_insert>("8ary", "insert");
+	run<sjtu::dary_heap<8>, sjtu::merge_adaptive>("8ary", "adaptive");
+	run<sjtu::pairing_heap, sjtu::merge_rebuild>("pairing", "meld");
+	run<sjtu::leftist_heap, sjtu::merge_rebuild>("leftist", "meld");
+#endif
+	return 0;
+}
@@ -0,0 +1,106 @@
+// connection-timeout style workload where most timers are cancelled before they fire:
+// timer_wheel against priority_queue with lazy deletion
+// build: g++ -std=c++17 -O2 -I.. timer_wheel.cpp -o timer_wheel
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "priority_queue.hpp"
+#include "timer_wheel.hpp"
+
+const int TIMERS = 2000000;
+const int TICKS = 200000;
+const int CANCEL_PERCENT = 95;
+
+unsigned long long seed = 19260817;
+unsigned long long nextRand()
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+long long fired = 0;
+struct fire_counter {
+	void operator()() const {++fired;}
+};
+
+// the heap baseline: cancelled timers stay in the heap until they reach the top
+struct heap_timers {
+	struct entry {
+		unsigned long long deadline;
+		int id;
+	};
+	struct later_first {
+		bool operator()(const entry &a, const entry &b) const {return a.deadline > b.deadline;}
+	};
+	sjtu::priority_queue<entry, later_first> heap;
+	std::vector<char> cancelled;
+	int schedule(unsigned long long deadline) {
+		cancelled.push_back(0);
+		heap.push(entry{deadline, (int)cancelled.size() - 1});
+		return (int)cancelled.size() - 1;
+	}
+	void cancel(int id) {cancelled[id] = 1;}
+	void advance(unsigned long long now) {
+		while (!heap.empty() && heap.top().deadline <= now) {
+			if (!cancelled[heap.top().id]) ++fired;
+			heap.pop();
+		}
+	}
+};
+
+template<class Timers, class Id>
+double run(Timers &timers, Id (*schedule)(Timers &, unsigned long long), void (*cancel)(Timers &, Id))
+{
+	seed = 19260817;
+	fired = 0;
+	std::vector<Id> ids;
+	ids.reserve(TIMERS);
+	auto start = std::chrono::steady_clock::now();
+	int perTick = TIMERS / TICKS;
+	for (unsigned long long now = 1; now <= TICKS; ++now) {
+		for (int i = 0; i < perTick; ++i) {
+			ids.push_back(schedule(timers, now + 1000 + nextRand() % 30000));
+			// cancel a random recent connection, as replies arrive
+			if ((int)(nextRand() % 100) < CANCEL_PERCENT) {
+				size_t k = ids.size() - 1 - nextRand() % (ids.size() < 1000 ? ids.size() : 1000);
+				cancel(timers, ids[k]);
+			}
+		}
+		timers.advance(now);
+	}
+	timers.advance(TICKS + 100000);
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+sjtu::timer_wheel<fire_counter>::timer_id wheelSchedule(sjtu::timer_wheel<fire_counter> &w, unsigned long long d)
+{
+	return w.schedule(d, fire_counter());
+}
+void wheelCancel(sjtu::timer_wheel<fire_counter> &w, sjtu::timer_wheel<fire_counter>::timer_id id)
+{
+	w.cancel(id);
+}
+int heapSchedule(heap_timers &h, unsigned long long d)
+{
+	return h.schedule(d);
+}
+void heapCancel(heap_timers &h, int id)
+{
+	h.cancel(id);
+}
+
+int main()
+{
+	heap_timers heap;
+	double a = run(heap, heapSchedule, heapCancel);
+	long long heapFired = fired;
+	sjtu::timer_wheel<fire_counter> wheel;
+	double b = run(wheel, wheelSchedule, wheelCancel);
+	printf("%d timers, ~%d%% cancelled\n", TIMERS, CANCEL_PERCENT);
+	printf("priority_queue + lazy cancel: %10.1f ms, %lld fired\n", a, heapFired);
+	printf("timer_wheel                 : %10.1f ms, %lld fired\n", b, fired);
+	return 0;
+}
@@ -0,0 +1,191 @@
+#ifndef SJTU_BUCKET_QUEUE_HPP
+#define SJTU_BUCKET_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * the default priority of an element: the element itself, as an integer.
+ */
+template<typename T>
+struct integer_priority {
+	size_t operator()(const T &e) const {return (size_t)e;}
+};
+
+/**
+ * a priority queue for small integer priorities 0..MaxPriority.
+ *
+ * every priority owns a FIFO bucket (a power-of-two circular array),
+ * a two-level bitmap of non-empty buckets finds the highest priority
+ * with two count-leading-zeros instructions, so push, top and pop are
+ * O(1) and never compare elements. elements with equal priority come
+ * out in the order they were pushed. the PriorityOf object is kept for
+ * the lifetime of the queue.
+ */
+template<typename T, size_t MaxPriority = 255, class PriorityOf = integer_priority<T>>
+class bucket_queue : private functor_holder<PriorityOf> {
+	static_assert(MaxPriority < 64 * 64, "bucket_queue supports priorities below 4096");
+private:
+	static const size_t BUCKETS = MaxPriority + 1, WORDS = (BUCKETS + 63) / 64;
+
+	struct bucket {
+		T* arr;
+		size_t head, count, cap;
+	};
+
+	bucket buckets[BUCKETS];
+	unsigned long long used[WORDS], summary;
+	size_t nowsize;
+
+	static int highestBit(unsigned long long x) {return 63 - __builtin_clzll(x);}
+
+	void mark(size_t p)
+	{
+		used[p / 64] |= 1ULL << (p % 64);
+		summary |= 1ULL << (p / 64);
+	}
+	void unmark(size_t p)
+	{
+		used[p / 64] &= ~(1ULL << (p % 64));
+		if (!used[p / 64]) summary &= ~(1ULL << (p / 64));
+	}
+	size_t topPriority() const
+	{
+		int w = highestBit(summary);
+		return w * 64 + highestBit(used[w]);
+	}
+
+	void doubleSpace(bucket &b)
+	{
+		size_t cap = b.cap ? b.cap * 2 : 8;
+		T* tmp = (T*)malloc(cap * sizeof(T));
+		for (size_t i = 0; i < b.count; ++i) {
+			T &e = b.arr[(b.head + i) & (b.cap - 1)];
+			new(tmp + i) T(e);
+			e.~T();
+		}
+		free(b.arr);
+		b.arr = tmp;
+		b.head = 0;
+		b.cap = cap;
+	}
+
+	void append(size_t p, const T &e)
+	{
+		bucket &b = buckets[p];
+		if (b.count == b.cap) doubleSpace(b);
+		new(b.arr + ((b.head + b.count) & (b.cap - 1))) T(e);
+		if (!b.count++) mark(p);
+	}
+
+	void init()
+	{
+		for (size_t i = 0; i < BUCKETS; ++i) buckets[i] = bucket{nullptr, 0, 0, 0};
+		for (size_t i = 0; i < WORDS; ++i) used[i] = 0;
+		summary = 0;
+		nowsize = 0;
+	}
+
+	void deleteSpace()
+	{
+		for (size_t p = 0; p < BUCKETS; ++p) {
+			bucket &b = buckets[p];
+			for (size_t i = 0; i < b.count; ++i)
+				b.arr[(b.head + i) & (b.cap - 1)].~T();
+			free(b.arr);
+		}
+		init();
+	}
+
+	void copyFrom(const bucket_queue &other)
+	{
+		for (size_t p = 0; p < BUCKETS; ++p) {
+			const bucket &b = other.buckets[p];
+			for (size_t i = 0; i < b.count; ++i)
+				append(p, b.arr[(b.head + i) & (b.cap - 1)]);
+		}
+		nowsize = other.nowsize;
+	}
+
+public:
+	explicit bucket_queue(const PriorityOf &priority_of = PriorityOf()): functor_holder<PriorityOf>(priority_of) {init();}
+	bucket_queue(const bucket_queue &other): functor_holder<PriorityOf>(other)
+	{
+		init();
+		copyFrom(other);
+	}
+	~bucket_queue() {deleteSpace();}
+	bucket_queue &operator=(const bucket_queue &other)
+	{
+		if (this == &other) return *this;
+		deleteSpace();
+		functor_holder<PriorityOf>::operator=(other);
+		copyFrom(other);
+		return *this;
+	}
+	/**
+	 * get the earliest pushed element of the highest priority.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top() const {
+		if (!nowsize) throw container_is_empty();
+		const bucket &b = buckets[topPriority()];
+		return b.arr[b.head];
+	}
+	/**
+	 * push new element.
+	 * throw index_out_of_bound if its priority exceeds MaxPriority.
+	 */
+	void push(const T &e) {
+		size_t p = functor_holder<PriorityOf>::get()(e);
+		if (p > MaxPriority) throw index_out_of_bound();
+		append(p, e);
+		++nowsize;
+	}
+	/**
+	 * delete the top element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop() {
+		if (!nowsize) throw container_is_empty();
+		size_t p = topPriority();
+		bucket &b = buckets[p];
+		b.arr[b.head].~T();
+		b.head = (b.head + 1) & (b.cap - 1);
+		if (!--b.count) unmark(p);
+		--nowsize;
+	}
+	size_t size() const {
+		return nowsize;
+	}
+	bool empty() const {
+		return !nowsize;
+	}
+	/**
+	 * the function object giving the priority of an element.
+	 */
+	const PriorityOf & priority_of() const {
+		return functor_holder<PriorityOf>::get();
+	}
+	/**
+	 * move all the elements of other behind the elements of the same priority here.
+	 */
+	void merge(bucket_queue &other) {
+		if (this == &other) return;
+		for (size_t p = 0; p < BUCKETS; ++p) {
+			bucket &b = other.buckets[p];
+			for (size_t i = 0; i < b.count; ++i)
+				append(p, b.arr[(b.head + i) & (b.cap - 1)]);
+		}
+		nowsize += other.nowsize;
+		other.deleteSpace();
+	}
+};
+
+}
+
+#endif
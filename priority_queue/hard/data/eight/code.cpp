@@ -0,0 +1,118 @@
+#include <iostream>
+#include <functional>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+#include <cstdlib>
+
+#include "timer_wheel.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+typedef std::pair<unsigned long long, int> timer;
+typedef sjtu::timer_wheel<> wheel;
+
+struct fired {
+	int id;
+	unsigned long long at;
+};
+
+// random schedule, cancel and advance, against a std::priority_queue of deadlines
+bool testAgainstStd(unsigned long long start)
+{
+	wheel w(start);
+	std::priority_queue<timer, std::vector<timer>, std::greater<timer>> ref;
+	std::vector<wheel::timer_id> ids;
+	std::vector<unsigned long long> deadline, scheduledAt;
+	std::set<int> live;
+	std::vector<fired> log;
+	unsigned long long now = start;
+	for (int i = 0; i < 100000; ++i) {
+		int op = rand64() % 10;
+		if (op < 5) {
+			unsigned long long d;
+			switch (rand64() % 4) {
+				case 0: d = now + rand64() % 300; break;
+				case 1: d = now + rand64() % 100000; break;
+				// beyond the last wheel
+				case 2: d = now + rand64() % (1ULL << 34); break;
+				default: d = now - rand64() % 5;
+			}
+			int id = ids.size();
+			ids.push_back(w.schedule(d, [id, &log, &w]() {log.push_back(fired{id, w.now()});}));
+			deadline.push_back(d);
+			scheduledAt.push_back(now);
+			ref.push(timer(d, id));
+			live.insert(id);
+		}
+		else if (op < 7 && !live.empty()) {
+			std::set<int>::iterator it = live.lower_bound(rand64() % ids.size());
+			int id = it == live.end() ? *live.begin() : *it;
+			if (!w.cancel(ids[id])) return false;
+			live.erase(id);
+			if (w.cancel(ids[id])) return false;
+		}
+		else {
+			now += rand64() % 4 ? rand64() % 500 : rand64() % (1ULL << 33);
+			log.clear();
+			size_t n = w.advance(now);
+			std::set<int> expected;
+			for (; !ref.empty() && ref.top().first <= now; ref.pop())
+				if (live.count(ref.top().second)) expected.insert(ref.top().second);
+			if (n != log.size() || n != expected.size()) return false;
+			for (size_t k = 0; k < log.size(); ++k) {
+				int id = log[k].id;
+				if (!expected.count(id)) return false;
+				// a timer set in the future fires exactly at its deadline
+				if (deadline[id] > scheduledAt[id] && log[k].at != deadline[id]) return false;
+				live.erase(id);
+			}
+		}
+		if (w.size() != live.size() || w.empty() != live.empty()) return false;
+	}
+	return true;
+}
+
+// the largest tick is a deadline like any other
+bool testLargestTick()
+{
+	const unsigned long long M = ~0ULL;
+	wheel empty;
+	if (empty.advance(M) != 0 || empty.now() != M) return false;
+	wheel w(100);
+	int count = 0;
+	w.schedule(M, [&count]() {++count;});
+	w.schedule(M - 5, [&count]() {++count;});
+	w.schedule(1000, [&count]() {++count;});
+	if (w.advance(M - 6) != 1 || w.advance(M - 1) != 1 || w.advance(M) != 1) return false;
+	return count == 3 && w.now() == M && w.empty() && w.advance(M) == 0;
+}
+
+// a callback may schedule further timers
+bool testReschedule()
+{
+	wheel w;
+	int count = 0;
+	std::function<void()> again = [&]() {
+		if (++count < 100) w.schedule(w.now() + 7, again);
+	};
+	w.schedule(7, again);
+	w.advance(10000);
+	return count == 100 && w.empty();
+}
+
+int main()
+{
+	std::cout << "against std::priority_queue: " << (testAgainstStd(0) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "against std::priority_queue, late start: " << (testAgainstStd(0xfffffff0ULL) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "largest tick: " << (testLargestTick() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "rescheduling callbacks: " << (testReschedule() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
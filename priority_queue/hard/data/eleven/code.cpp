@@ -0,0 +1,155 @@
+#include <iostream>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdlib>
+
+#include "priority_queue.hpp"
+#include "keyed_priority_queue.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// orders by the value modulo mod, then by the value; a fresh one has mod 1, the plain order
+struct modCompare {
+	int mod;
+	modCompare(int _mod = 1): mod(_mod) {}
+	bool operator()(int a, int b) const {return a % mod != b % mod ? a % mod < b % mod : a < b;}
+};
+
+// a comparator object kept by the queue, through copies, assignment and merges
+template<class Storage>
+bool testStoredComparator()
+{
+	typedef sjtu::priority_queue<int, modCompare, Storage> queue;
+	modCompare c(97);
+	queue q(c), other(c);
+	std::priority_queue<int, std::vector<int>, modCompare> ref(c);
+	if (q.value_comp().mod != 97) return false;
+	for (int i = 0; i < 100000; ++i) {
+		int op = rand64() % 100;
+		if (op < 45) {
+			int x = rand64() % 1000000;
+			q.push(x);
+			ref.push(x);
+		}
+		else if (op < 47) {
+			for (int k = 0; k < 10; ++k) {
+				int x = rand64() % 1000000;
+				other.push(x);
+				ref.push(x);
+			}
+		}
+		else if (op < 99) {
+			if (!other.empty()) {
+				q.merge(other);
+				if (!other.empty()) return false;
+			}
+			if (ref.empty()) continue;
+			if (q.top() != ref.top()) return false;
+			q.pop();
+			ref.pop();
+		}
+		else {
+			q.merge(other);
+			queue copy(q);
+			queue assigned;
+			assigned = copy;
+			if (copy.value_comp().mod != 97 || assigned.value_comp().mod != 97) return false;
+			if (!q.empty() && (copy.top() != q.top() || assigned.top() != q.top())) return false;
+		}
+	}
+	q.merge(other);
+	if (!other.empty() || q.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop()) {
+		if (q.top() != ref.top()) return false;
+		q.pop();
+	}
+	return q.empty();
+}
+
+// the key of an element is its score in a table, KeyOf counts how often it is asked
+struct scoreOf {
+	const std::vector<int> *score;
+	long long *calls;
+	scoreOf(const std::vector<int> *_score = nullptr, long long *_calls = nullptr): score(_score), calls(_calls) {}
+	int operator()(const std::string &s) const {
+		++*calls;
+		return (*score)[std::stoi(s)];
+	}
+};
+
+// keyed_priority_queue against std::priority_queue of (key, element) pairs
+bool testKeyed(sjtu::pop_strategy strategy)
+{
+	const int N = 5000;
+	std::vector<int> score(N);
+	for (int i = 0; i < N; ++i) score[i] = rand64() % 300;
+	long long calls = 0, pushes = 0;
+	typedef sjtu::keyed_priority_queue<std::string, scoreOf, std::greater<int>> queue;
+	queue q(scoreOf(&score, &calls), std::greater<int>(), strategy), other(scoreOf(&score, &calls));
+	std::priority_queue<std::pair<int, std::string>, std::vector<std::pair<int, std::string>>,
+		std::greater<std::pair<int, std::string>>> ref;
+	for (int i = 0; i < 100000; ++i) {
+		int op = rand64() % 100, id = rand64() % N;
+		std::string s = std::to_string(id);
+		if (op < 35) {
+			q.push(s);
+			++pushes;
+			ref.push(std::make_pair(score[id], s));
+		}
+		else if (op < 45) {
+			// a key given by the caller is used as is, KeyOf is not asked
+			int key = rand64() % 300;
+			q.push(key, s);
+			ref.push(std::make_pair(key, s));
+		}
+		else if (op < 47) {
+			other.push(s);
+			++pushes;
+			ref.push(std::make_pair(score[id], s));
+		}
+		else {
+			if (!other.empty()) {
+				q.merge(other);
+				if (!other.empty()) return false;
+			}
+			if (ref.empty()) continue;
+			// elements of equal keys may come out in any order, only the key is fixed
+			if (q.top_key() != ref.top().first) return false;
+			ref.pop();
+			q.pop();
+		}
+		if (calls != pushes) return false;
+	}
+	q.merge(other);
+	if (q.size() != ref.size()) return false;
+	for (; !ref.empty(); ref.pop()) {
+		if (q.top_key() != ref.top().first) return false;
+		q.pop();
+	}
+	try {
+		q.top();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	return q.empty() && calls == pushes && q.key_comp()(2, 1);
+}
+
+int main()
+{
+	std::cout << "stored comparator, binary heap: " << (testStoredComparator<sjtu::binary_heap>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "stored comparator, 4-ary heap: " << (testStoredComparator<sjtu::dary_heap<4>>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "stored comparator, pairing heap: " << (testStoredComparator<sjtu::pairing_heap>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "stored comparator, leftist heap: " << (testStoredComparator<sjtu::leftist_heap>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "keyed_priority_queue: " << (testKeyed(sjtu::pop_strategy::top_down) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "keyed_priority_queue, bottom-up: " << (testKeyed(sjtu::pop_strategy::bottom_up) ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
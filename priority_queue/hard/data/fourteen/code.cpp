@@ -0,0 +1,125 @@
+#include <iostream>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "priority_queue.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+int smallInt() {return rand64() % 1000;}
+std::string shortString() {return std::to_string(rand64() % 5000);}
+
+// push, pop, replace_top, merges, copies and strategy switches against std::priority_queue
+template<class T, class Storage, class Merge>
+bool testAgainstStd(T (*make)())
+{
+	typedef sjtu::priority_queue<T, std::less<T>, Storage, Merge> queue;
+	queue q, other;
+	std::priority_queue<T> ref, refOther;
+	for (int i = 0; i < 100000; ++i) {
+		int op = rand64() % 100;
+		if (op < 48) {
+			T x = make();
+			q.push(x);
+			ref.push(x);
+		}
+		else if (op < 50) {
+			for (int k = rand64() % 20; k > 0; --k) {
+				T x = make();
+				other.push(x);
+				refOther.push(x);
+			}
+		}
+		else if (op < 51) {
+			// small into large, then large into empty and back
+			q.merge(other);
+			for (; !refOther.empty(); refOther.pop()) ref.push(refOther.top());
+			if (!other.empty()) return false;
+			if (rand64() % 10 == 0) {
+				other.merge(q);
+				if (!q.empty()) return false;
+				q.merge(other);
+			}
+			q.merge(q);
+		}
+		else if (op < 54) {
+			if (ref.empty()) continue;
+			T x = make();
+			if (q.top() != ref.top()) return false;
+			q.replace_top(x);
+			ref.pop();
+			ref.push(x);
+		}
+		else if (op < 99) {
+			if (ref.empty()) continue;
+			if (q.top() != ref.top()) return false;
+			q.pop();
+			ref.pop();
+		}
+		else if (rand64() % 10 == 0) {
+			sjtu::pop_strategy s = rand64() % 2 ? sjtu::pop_strategy::bottom_up : sjtu::pop_strategy::top_down;
+			q.set_pop_strategy(s);
+			// copies pop the same sequence
+			queue copy(q), assigned;
+			assigned = q;
+			assigned = assigned;
+			std::priority_queue<T> r = ref;
+			for (int k = 0; k < 100 && !r.empty(); ++k, r.pop()) {
+				if (copy.top() != r.top() || assigned.top() != r.top()) return false;
+				copy.pop();
+				assigned.pop();
+			}
+		}
+		if (q.size() != ref.size() || other.size() != refOther.size() || q.empty() != ref.empty()) return false;
+	}
+	q.merge(other);
+	for (; !refOther.empty(); refOther.pop()) ref.push(refOther.top());
+	for (; !ref.empty(); ref.pop()) {
+		if (q.top() != ref.top()) return false;
+		q.pop();
+	}
+	try {
+		q.top();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	try {
+		q.pop();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	try {
+		q.replace_top(make());
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	return q.empty() && other.empty();
+}
+
+template<class Storage>
+void testEngine(const char *name)
+{
+	std::cout << name << ", merge_rebuild: " << (testAgainstStd<int, Storage, sjtu::merge_rebuild>(smallInt) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << name << ", merge_insert: " << (testAgainstStd<int, Storage, sjtu::merge_insert>(smallInt) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << name << ", merge_adaptive, strings: " << (testAgainstStd<std::string, Storage, sjtu::merge_adaptive>(shortString) ? "OKAY" : "FAIL") << std::endl;
+}
+
+int main()
+{
+	testEngine<sjtu::binary_heap>("binary heap");
+	testEngine<sjtu::dary_heap<3>>("3-ary heap");
+	testEngine<sjtu::dary_heap<4>>("4-ary heap");
+	testEngine<sjtu::dary_heap<8>>("8-ary heap");
+	testEngine<sjtu::pairing_heap>("pairing heap");
+	testEngine<sjtu::leftist_heap>("leftist heap");
+	return 0;
+}
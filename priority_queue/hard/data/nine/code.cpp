@@ -0,0 +1,127 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "multi_queue.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// ascending or descending by the flag it was built with, a fresh one is ascending
+struct flipCompare {
+	bool greater;
+	flipCompare(bool _greater = false): greater(_greater) {}
+	bool operator()(int a, int b) const {return greater ? a > b : a < b;}
+};
+
+// one thread and one heap: exact, pop for pop like std::priority_queue
+template<class Compare>
+bool testExact(const Compare &c)
+{
+	sjtu::multi_queue<int, Compare> q(1, 1, c);
+	std::priority_queue<int, std::vector<int>, Compare> ref(c);
+	if (q.heap_count() != 1) return false;
+	for (int i = 0; i < 200000; ++i) {
+		if (rand64() % 5 < 3) {
+			int x = rand64() % 100000;
+			q.push(x);
+			ref.push(x);
+		}
+		else {
+			int x = -1;
+			bool found = q.try_pop(x);
+			if (found != !ref.empty()) return false;
+			if (found) {
+				if (x != ref.top()) return false;
+				ref.pop();
+			}
+		}
+		if (i % 1000 == 0 && (q.size() != ref.size() || q.empty() != ref.empty())) return false;
+	}
+	for (; !ref.empty(); ref.pop())
+		if (q.pop() != ref.top()) return false;
+	try {
+		q.pop();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	int x;
+	return !q.try_pop(x) && q.empty();
+}
+
+// several heaps, one thread: every element comes out once, close to the top.
+// the heaps must order by the comparator object passed in, a fresh flipCompare()
+// would pop the largest elements first
+bool testRelaxed()
+{
+	const int N = 100000;
+	sjtu::multi_queue<int, flipCompare> q(4, 2, flipCompare(true));
+	if (q.heap_count() != 8 || !q.value_comp().greater) return false;
+	std::vector<int> order(N);
+	for (int i = 0; i < N; ++i) order[i] = i;
+	for (int i = N - 1; i > 0; --i) std::swap(order[i], order[rand64() % (i + 1)]);
+	for (int i = 0; i < N; ++i) q.push(order[i]);
+	if (q.size() != (size_t)N) return false;
+	// a fenwick tree over the elements still queued gives the rank of each popped one
+	std::vector<int> tree(N + 1, 0), seen(N, 0);
+	for (int i = 1; i <= N; ++i)
+		for (int j = i; j <= N; j += j & -j) ++tree[j];
+	long long rankSum = 0;
+	for (int k = 0; k < N; ++k) {
+		int x = q.pop();
+		if (x < 0 || x >= N || seen[x]) return false;
+		seen[x] = 1;
+		int rank = 0;
+		for (int j = x; j > 0; j -= j & -j) rank += tree[j];
+		rankSum += rank;
+		for (int j = x + 1; j <= N; j += j & -j) --tree[j];
+	}
+	// two-choice popping keeps the mean rank at O(heaps)
+	return rankSum / N < 64 && q.empty();
+}
+
+// threads pushing and popping at once: every element pushed is popped exactly once
+bool testThreads(int threadNum, int perThread)
+{
+	sjtu::multi_queue<int> q(threadNum);
+	std::vector<std::vector<int>> popped(threadNum);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadNum; ++t)
+		threads.emplace_back([&, t]() {
+			for (int i = 0; i < perThread; ++i) {
+				q.push(t * perThread + i);
+				if (i % 3 == 2) {
+					int x;
+					if (q.try_pop(x)) popped[t].push_back(x);
+				}
+			}
+		});
+	for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+	std::vector<int> all;
+	for (int t = 0; t < threadNum; ++t) all.insert(all.end(), popped[t].begin(), popped[t].end());
+	int x;
+	while (q.try_pop(x)) all.push_back(x);
+	std::sort(all.begin(), all.end());
+	if (all.size() != (size_t)threadNum * perThread) return false;
+	for (size_t i = 0; i < all.size(); ++i)
+		if (all[i] != (int)i) return false;
+	return q.empty();
+}
+
+int main()
+{
+	std::cout << "single heap against std::priority_queue: " << (testExact(std::less<int>()) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "single heap, stored comparator: " << (testExact(flipCompare(true)) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "eight heaps, relaxed order: " << (testRelaxed() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "four threads: " << (testThreads(4, 50000) ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
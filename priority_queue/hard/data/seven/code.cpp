@@ -0,0 +1,125 @@
+#include <iostream>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "external_priority_queue.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	reed += (reed << 5) + 172741827;
+	return reed >> 1;
+}
+
+// pushes and pops in phases, the queue spills to dir
+bool testAgainstStd(size_t memoryLimit, size_t bufferBytes, size_t fanIn, bool spills, const std::string &dir = ".")
+{
+	sjtu::external_priority_queue<long long> q(dir, memoryLimit, bufferBytes, fanIn);
+	std::priority_queue<long long> s;
+	for (int i = 0; i < 400000; ++i) {
+		if (rand() % 5 < 3 || i < 100000) {
+			long long x = (long long)rand() * 1000 + i % 1000;
+			q.push(x);
+			s.push(x);
+		}
+		else if (!s.empty()) {
+			if (q.top() != s.top()) return false;
+			q.pop();
+			s.pop();
+		}
+		if (q.size() != s.size() || q.empty() != s.empty()) return false;
+	}
+	if ((q.stat().runs_written > 0) != spills || q.stat().spilled_bytes < q.stat().read_bytes) return false;
+	while (!s.empty()) {
+		if (q.top() != s.top()) return false;
+		q.pop();
+		s.pop();
+	}
+	return q.empty() && !q.open_runs() && q.stat().spilled_bytes == q.stat().read_bytes;
+}
+
+// merging in levels keeps fan_in - 1 runs per level at most
+bool testOpenRuns()
+{
+	const size_t fanIn = 4;
+	sjtu::external_priority_queue<int> q(".", 1024, 256, fanIn);
+	std::priority_queue<int> s;
+	size_t maxOpen = 0;
+	for (int i = 0; i < 300000; ++i) {
+		int x = rand();
+		q.push(x);
+		s.push(x);
+		if (q.open_runs() > maxOpen) maxOpen = q.open_runs();
+	}
+	// 300000 ints in runs of 256 are about 1200 runs, fewer than 4^6
+	if (maxOpen > (fanIn - 1) * 6 || !q.stat().merges) return false;
+	while (!s.empty()) {
+		if (q.top() != s.top()) return false;
+		q.pop();
+		s.pop();
+	}
+	return q.empty();
+}
+
+bool testComparator()
+{
+	sjtu::external_priority_queue<int, std::greater<int>> q(".", 4096, 512);
+	std::priority_queue<int, std::vector<int>, std::greater<int>> s;
+	for (int i = 0; i < 100000; ++i) {
+		int x = rand() % 50000;
+		q.push(x);
+		s.push(x);
+	}
+	while (!s.empty()) {
+		if (q.top() != s.top()) return false;
+		q.pop();
+		s.pop();
+	}
+	return q.empty();
+}
+
+// a forked child has a queue at the same address as its parent's, both
+// spilling into the same directory at the same time must not meet
+bool testTwoProcesses()
+{
+	pid_t pid = fork();
+	if (pid < 0) return false;
+	if (pid == 0) {
+		// different elements from the parent
+		for (int i = 0; i < 1000; ++i) rand();
+		_exit(testAgainstStd(512, 64, 4, true) ? 0 : 1);
+	}
+	bool ok = testAgainstStd(512, 64, 4, true);
+	int status = 0;
+	if (waitpid(pid, &status, 0) != pid) return false;
+	return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+bool testException()
+{
+	sjtu::external_priority_queue<int> q(".", 64);
+	int thrown = 0;
+	try {q.top();} catch (sjtu::container_is_empty &) {++thrown;}
+	try {q.pop();} catch (sjtu::container_is_empty &) {++thrown;}
+	for (int i = 0; i < 100; ++i) q.push(i);
+	while (!q.empty()) q.pop();
+	try {q.pop();} catch (sjtu::container_is_empty &) {++thrown;}
+	return thrown == 3;
+}
+
+int main()
+{
+	std::cout << "in memory: " << (testAgainstStd(64 << 20, 64 << 10, 16, false) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "spilling: " << (testAgainstStd(4096, 1024, 16, true) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "spilling, fan in 2: " << (testAgainstStd(512, 64, 2, true) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "spilling to tmpfile: " << (testAgainstStd(4096, 1024, 16, true, "") ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "two processes: " << (testTwoProcesses() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "open runs: " << (testOpenRuns() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "comparator: " << (testComparator() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "exceptions: " << (testException() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+#include <map>
+#include <queue>
+#include <vector>
+#include <cstdlib>
+
+#include "minmax_heap.hpp"
+
+int rand() {
+	static unsigned reed = 1727417277;
+	reed += (reed << 5) + 172741827;
+	return reed >> 1;
+}
+
+// a multiset kept as the count of every value
+struct bag {
+	std::map<int, int> count;
+	size_t size;
+
+	bag(): size(0) {}
+	void insert(int x)
+	{
+		++count[x];
+		++size;
+	}
+	void erase(int x)
+	{
+		if (!--count[x]) count.erase(x);
+		--size;
+	}
+	bool empty() const {return !size;}
+	int min() const {return count.begin()->first;}
+	int max() const {return count.rbegin()->first;}
+};
+
+bool same(const sjtu::minmax_heap<int> &h, const bag &b)
+{
+	if (h.size() != b.size || h.empty() != b.empty()) return false;
+	if (b.empty()) return true;
+	return h.min() == b.min() && h.max() == b.max();
+}
+
+bool testRandom()
+{
+	sjtu::minmax_heap<int> h;
+	bag b;
+	for (int i = 0; i < 300000; ++i) {
+		int op = rand() % 5;
+		if (op < 2 || b.empty()) {
+			int x = rand() % 1000;
+			h.push(x);
+			b.insert(x);
+		}
+		else if (op == 2) {
+			b.erase(h.min());
+			h.pop_min();
+		}
+		else if (op == 3) {
+			b.erase(h.max());
+			h.pop_max();
+		}
+		if (!same(h, b)) return false;
+	}
+	// drain from both ends at once
+	while (!b.empty()) {
+		if (h.min() != b.min()) return false;
+		b.erase(h.min());
+		h.pop_min();
+		if (b.empty()) break;
+		if (h.max() != b.max()) return false;
+		b.erase(h.max());
+		h.pop_max();
+	}
+	return h.empty();
+}
+
+bool testCopy()
+{
+	sjtu::minmax_heap<int> h;
+	bag b;
+	for (int i = 0; i < 10000; ++i) {
+		int x = rand();
+		h.push(x);
+		b.insert(x);
+	}
+	sjtu::minmax_heap<int> c(h), d;
+	d.push(1);
+	d = h;
+	d = d;
+	for (int i = 0; i < 5000; ++i) {
+		c.pop_min();
+		d.pop_max();
+	}
+	if (!same(h, b) || c.size() != 5000 || d.size() != 5000) return false;
+	return c.max() == h.max() && d.min() == h.min();
+}
+
+bool testMerge()
+{
+	sjtu::minmax_heap<int> a, c;
+	bag b;
+	for (int i = 0; i < 50000; ++i) {
+		int x = rand() % 100000;
+		if (i % 3) a.push(x);
+		else c.push(x);
+		b.insert(x);
+	}
+	a.merge(c);
+	if (!c.empty() || !same(a, b)) return false;
+	while (!b.empty()) {
+		b.erase(a.max());
+		a.pop_max();
+		if (!same(a, b)) return false;
+	}
+	return true;
+}
+
+bool testException()
+{
+	sjtu::minmax_heap<int> h;
+	int thrown = 0;
+	try {h.min();} catch (sjtu::container_is_empty &) {++thrown;}
+	try {h.max();} catch (sjtu::container_is_empty &) {++thrown;}
+	try {h.pop_min();} catch (sjtu::container_is_empty &) {++thrown;}
+	try {h.pop_max();} catch (sjtu::container_is_empty &) {++thrown;}
+	return thrown == 4;
+}
+
+// orders by the remainder modulo m first, so its state matters
+struct by_mod {
+	int m;
+	bool operator()(int a, int b) const {return a % m < b % m || (a % m == b % m && a < b);}
+};
+
+bool testComparator()
+{
+	sjtu::minmax_heap<int, by_mod> h(by_mod{7});
+	std::priority_queue<int, std::vector<int>, by_mod> q(by_mod{7});
+	for (int i = 0; i < 20000; ++i) {
+		int x = rand() % 100000;
+		h.push(x);
+		q.push(x);
+	}
+	while (!q.empty()) {
+		if (h.max() != q.top()) return false;
+		h.pop_max();
+		q.pop();
+	}
+	return h.empty() && h.value_comp().m == 7;
+}
+
+int main()
+{
+	std::cout << "random push, pop_min and pop_max: " << (testRandom() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "copy and assignment: " << (testCopy() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "merge: " << (testMerge() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "exceptions: " << (testException() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "stateful comparator: " << (testComparator() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "priority_queue.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// std::less which counts its calls
+struct countingLess {
+	long long *count;
+	countingLess(long long *_count = nullptr): count(_count) {}
+	bool operator()(int a, int b) const {
+		if (count) ++*count;
+		return a < b;
+	}
+};
+
+// random push, pop and strategy switches against std::priority_queue
+template<class Queue, class T>
+bool testAgainstStd(T (*make)(), sjtu::pop_strategy first)
+{
+	Queue q(first);
+	std::priority_queue<T> ref;
+	if (q.get_pop_strategy() != first) return false;
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand64() % 100;
+		if (op < 55) {
+			T x = make();
+			q.push(x);
+			ref.push(x);
+		}
+		else if (op < 99) {
+			if (ref.empty()) continue;
+			if (q.top() != ref.top()) return false;
+			q.pop();
+			ref.pop();
+		}
+		else {
+			sjtu::pop_strategy s = rand64() % 2 ? sjtu::pop_strategy::bottom_up : sjtu::pop_strategy::top_down;
+			q.set_pop_strategy(s);
+			if (q.get_pop_strategy() != s) return false;
+		}
+		if (q.size() != ref.size() || q.empty() != ref.empty()) return false;
+	}
+	// a copy keeps the strategy and pops the same sequence
+	Queue copy(q);
+	if (copy.get_pop_strategy() != q.get_pop_strategy()) return false;
+	for (; !ref.empty(); ref.pop()) {
+		if (q.top() != ref.top() || copy.top() != ref.top()) return false;
+		q.pop();
+		copy.pop();
+	}
+	try {
+		q.pop();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	return q.empty() && copy.empty();
+}
+
+int smallInt() {return rand64() % 1000;}
+std::string shortString() {return std::to_string(rand64() % 5000);}
+
+// draining a large heap, bottom-up pop needs fewer comparisons than top-down
+template<class Storage>
+bool testComparisons()
+{
+	long long count[2] = {0, 0};
+	sjtu::pop_strategy strategy[2] = {sjtu::pop_strategy::top_down, sjtu::pop_strategy::bottom_up};
+	for (int k = 0; k < 2; ++k) {
+		sjtu::priority_queue<int, countingLess, Storage> q(countingLess(&count[k]), strategy[k]);
+		for (int i = 0; i < 100000; ++i) q.push(i * 7919 % 100003);
+		count[k] = 0;
+		int last = 1 << 30;
+		for (; !q.empty(); q.pop()) {
+			if (q.top() > last) return false;
+			last = q.top();
+		}
+	}
+	return count[1] < count[0];
+}
+
+int main()
+{
+	std::cout << "binary heap, bottom-up: " << (testAgainstStd<sjtu::priority_queue<int>>(smallInt, sjtu::pop_strategy::bottom_up) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "binary heap, strings: " << (testAgainstStd<sjtu::priority_queue<std::string>>(shortString, sjtu::pop_strategy::bottom_up) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "4-ary heap, bottom-up: " << (testAgainstStd<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>>>(smallInt, sjtu::pop_strategy::bottom_up) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "3-ary heap, top-down first: " << (testAgainstStd<sjtu::priority_queue<std::string, std::less<std::string>, sjtu::dary_heap<3>>>(shortString, sjtu::pop_strategy::top_down) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "fewer comparisons, binary heap: " << (testComparisons<sjtu::binary_heap>() ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "fewer comparisons, 4-ary heap: " << (testComparisons<sjtu::dary_heap<4>>() ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdlib>
+
+#include "bucket_queue.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// an element carries its priority and a serial number
+struct task {
+	size_t priority;
+	long long serial;
+	std::string name;
+};
+// the priority of a task, shifted down by the shift it was built with
+struct priorityOf {
+	int shift;
+	priorityOf(int _shift = 0): shift(_shift) {}
+	size_t operator()(const task &t) const {return t.priority >> shift;}
+};
+
+// a std::priority_queue ordered by priority, then first pushed first
+typedef std::pair<size_t, long long> rank;
+typedef std::priority_queue<rank, std::vector<rank>, std::less<rank>> reference;
+
+template<size_t MaxPriority>
+bool testAgainstStd(int shift)
+{
+	typedef sjtu::bucket_queue<task, MaxPriority, priorityOf> queue;
+	priorityOf by(shift);
+	queue q(by), other(by);
+	reference ref;
+	long long serial = 0;
+	if (q.priority_of().shift != shift) return false;
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand64() % 100;
+		if (op < 50) {
+			size_t p = rand64() % ((MaxPriority + 1) << shift);
+			q.push(task{p, serial, std::to_string(serial)});
+			ref.push(rank(p >> shift, -serial++));
+		}
+		else if (op < 52) {
+			// the tasks of other come out behind those of equal priority in q, in their own order
+			for (int k = rand64() % 50; k > 0; --k) {
+				size_t p = rand64() % ((MaxPriority + 1) << shift);
+				other.push(task{p, serial, std::to_string(serial)});
+				ref.push(rank(p >> shift, -serial++));
+			}
+			q.merge(other);
+			if (!other.empty()) return false;
+		}
+		else if (op < 99) {
+			if (ref.empty()) continue;
+			const task &t = q.top();
+			if (t.priority >> shift != ref.top().first || t.serial != -ref.top().second || t.name != std::to_string(t.serial)) return false;
+			q.pop();
+			ref.pop();
+		}
+		else if (rand64() % 20 == 0) {
+			// copies pop the same sequence
+			queue copy(q), assigned(by);
+			assigned = q;
+			reference r = ref;
+			for (int k = 0; k < 100 && !r.empty(); ++k, r.pop()) {
+				if (copy.top().serial != -r.top().second || assigned.top().serial != -r.top().second) return false;
+				copy.pop();
+				assigned.pop();
+			}
+		}
+		if (q.size() != ref.size() || q.empty() != ref.empty()) return false;
+	}
+	for (; !ref.empty(); ref.pop()) {
+		if (q.top().serial != -ref.top().second) return false;
+		q.pop();
+	}
+	try {
+		q.pop();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	try {
+		q.push(task{(MaxPriority + 1) << shift, 0, ""});
+		return false;
+	}
+	catch (sjtu::index_out_of_bound &) {}
+	return q.empty();
+}
+
+int main()
+{
+	std::cout << "priorities 0..63: " << (testAgainstStd<63>(0) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "priorities 0..64: " << (testAgainstStd<64>(0) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "priorities 0..255, shifted: " << (testAgainstStd<255>(3) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "priorities 0..4095: " << (testAgainstStd<4095>(0) ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <type_traits>
+#include <vector>
+#include <cstdlib>
+
+#include "kway_merge.hpp"
+
+unsigned long long rand64() {
+	static unsigned long long seed = 19260817;
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return seed;
+}
+
+// an element remembers where it came from, only its key is compared
+struct item {
+	int key, run, pos;
+};
+struct keyLess {
+	bool operator()(const item &a, const item &b) const {return a.key < b.key;}
+};
+bool same(const item &a, const item &b) {return a.key == b.key && a.run == b.run && a.pos == b.pos;}
+
+typedef std::vector<item>::const_iterator runIterator;
+typedef sjtu::kway_merge<runIterator, keyLess> merger;
+
+static_assert(std::is_same<std::iterator_traits<merger::iterator>::iterator_category, std::input_iterator_tag>::value,
+	"kway_merge::iterator is an input iterator");
+
+// k sorted runs of random lengths, some empty, with many equal keys
+std::vector<std::vector<item>> makeRuns(int k, int maxLength, int keys)
+{
+	std::vector<std::vector<item>> runs(k);
+	for (int r = 0; r < k; ++r) {
+		int n = rand64() % 4 ? rand64() % (maxLength + 1) : 0;
+		for (int i = 0; i < n; ++i) runs[r].push_back(item{(int)(rand64() % keys), r, 0});
+		std::sort(runs[r].begin(), runs[r].end(), keyLess());
+		for (int i = 0; i < n; ++i) runs[r][i].pos = i;
+	}
+	return runs;
+}
+
+// the merge equals a stable sort of the runs laid out one after another
+std::vector<item> expected(const std::vector<std::vector<item>> &runs)
+{
+	std::vector<item> all;
+	for (size_t r = 0; r < runs.size(); ++r) all.insert(all.end(), runs[r].begin(), runs[r].end());
+	std::stable_sort(all.begin(), all.end(), keyLess());
+	return all;
+}
+
+// top() and pop() one by one
+bool testPop(int k, int maxLength, int keys)
+{
+	std::vector<std::vector<item>> runs = makeRuns(k, maxLength, keys);
+	std::vector<item> ref = expected(runs);
+	merger m;
+	size_t nonEmpty = 0;
+	for (int r = 0; r < k; ++r) {
+		m.add_run(runs[r].begin(), runs[r].end());
+		if (!runs[r].empty()) ++nonEmpty;
+	}
+	if (m.active_runs() != nonEmpty) return false;
+	for (size_t i = 0; i < ref.size(); ++i) {
+		if (m.empty() || !same(m.top(), ref[i])) return false;
+		m.pop();
+	}
+	if (!m.empty() || m.active_runs() != 0) return false;
+	try {
+		m.top();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	try {
+		m.pop();
+		return false;
+	}
+	catch (sjtu::container_is_empty &) {}
+	return true;
+}
+
+// a range-for over the iterator, after part of the merge was popped already
+bool testIterator(int k, int maxLength, int keys)
+{
+	std::vector<std::vector<item>> runs = makeRuns(k, maxLength, keys);
+	std::vector<item> ref = expected(runs);
+	merger m;
+	for (int r = 0; r < k; ++r) m.add_run(runs[r].begin(), runs[r].end());
+	size_t i = 0;
+	for (; i < ref.size() / 3; ++i) m.pop();
+	for (const item &x : m) {
+		if (i >= ref.size() || !same(x, ref[i])) return false;
+		++i;
+	}
+	return i == ref.size() && m.empty() && m.begin() == m.end();
+}
+
+// merge_into a container, with std::greater over descending runs of another iterator type
+bool testMergeInto(int k, int maxLength)
+{
+	std::vector<std::list<int>> runs(k);
+	std::vector<int> ref;
+	for (int r = 0; r < k; ++r) {
+		int n = rand64() % (maxLength + 1);
+		for (int i = 0; i < n; ++i) runs[r].push_back(rand64() % 1000);
+		runs[r].sort(std::greater<int>());
+		ref.insert(ref.end(), runs[r].begin(), runs[r].end());
+	}
+	std::sort(ref.begin(), ref.end(), std::greater<int>());
+	sjtu::kway_merge<std::list<int>::const_iterator, std::greater<int>> m;
+	for (int r = 0; r < k; ++r) m.add_run(runs[r].cbegin(), runs[r].cend());
+	std::vector<int> out;
+	m.merge_into(out);
+	return out == ref && m.empty();
+}
+
+int main()
+{
+	std::cout << "two runs: " << (testPop(2, 1000, 50) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "sixty-four runs: " << (testPop(64, 2000, 100) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "thousand short runs: " << (testPop(1000, 20, 10) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "one key, stability: " << (testPop(100, 100, 1) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "no runs: " << (testPop(0, 0, 1) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "iterator: " << (testIterator(50, 500, 30) ? "OKAY" : "FAIL") << std::endl;
+	std::cout << "merge_into with std::greater: " << (testMergeInto(30, 300) ? "OKAY" : "FAIL") << std::endl;
+	return 0;
+}
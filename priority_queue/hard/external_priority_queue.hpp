@@ -0,0 +1,331 @@
+#ifndef SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+#define SJTU_EXTERNAL_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a priority queue which may hold more elements than fit in memory.
+ *
+ * new elements go into an ordinary in-memory priority_queue. once that
+ * heap grows past the memory limit, it is drained in priority order into
+ * a sorted run file in the spill directory. top()/pop() merge the
+ * in-memory heap with the heads of all runs, each run being read
+ * sequentially through its own buffer. run files are removed as soon as
+ * they are exhausted, or when the queue is destroyed. each run file is
+ * created by mkstemp, so queues in other processes sharing the directory
+ * never open it; with an empty directory runs go to tmpfile() instead.
+ *
+ * every run is open while it has elements, so runs are merged in levels
+ * to bound the open files: a spilled run is on level 0, and once fan_in
+ * of the newest runs share a level they are merged into one run on the
+ * next level. at most fan_in - 1 runs per level stay open, and every
+ * element is rewritten once per level, about log_fan_in(spilled bytes /
+ * memory limit) times.
+ *
+ * elements are written as raw bytes, so T must be trivially copyable.
+ */
+template<typename T, class Compare = std::less<T>>
+class external_priority_queue {
+	static_assert(std::is_trivially_copyable<T>::value, "external_priority_queue needs a trivially copyable T");
+public:
+	struct statistics {
+		// including the bytes rewritten by merges
+		size_t spilled_bytes = 0;
+		size_t read_bytes = 0;
+		size_t runs_written = 0;
+		size_t merges = 0;
+	};
+
+private:
+	// a sorted run on disk, buffered for sequential reads
+	struct run {
+		FILE *file;
+		// empty for a tmpfile(), which the system removes itself
+		std::string path;
+		T *buffer;
+		size_t pos, loaded, remain;
+		int level;
+	};
+	// a run head inside the merge heap
+	struct head {
+		T value;
+		size_t id;
+	};
+	struct head_compare {
+		bool operator()(const head &a, const head &b) const {return Compare()(a.value, b.value);}
+	};
+
+	priority_queue<T, Compare> heap;
+	priority_queue<head, head_compare> heads;
+	run *runs;
+	size_t runCount, runCapacity, total;
+	size_t memoryLimit, bufferItems, fanIn;
+	std::string directory;
+	statistics stats;
+
+	void closeRun(run &r)
+	{
+		if (r.file) {
+			fclose(r.file);
+			if (!r.path.empty()) std::remove(r.path.c_str());
+			r.file = nullptr;
+		}
+		free(r.buffer);
+		r.buffer = nullptr;
+	}
+
+	// the next element of run id, refilling its buffer if needed.
+	// nullptr once the run is exhausted, it is closed then
+	const T * next(size_t id)
+	{
+		run &r = runs[id];
+		if (r.pos == r.loaded) {
+			if (!r.remain) {
+				closeRun(r);
+				return nullptr;
+			}
+			size_t want = r.remain < bufferItems ? r.remain : bufferItems;
+			r.loaded = fread(r.buffer, sizeof(T), want, r.file);
+			if (r.loaded != want) throw runtime_error();
+			stats.read_bytes += r.loaded * sizeof(T);
+			r.remain -= r.loaded;
+			r.pos = 0;
+		}
+		return r.buffer + r.pos++;
+	}
+
+	// push the next element of run id as a head
+	void advance(size_t id)
+	{
+		const T *e = next(id);
+		if (e) heads.push(head{*e, id});
+	}
+
+	// append a new empty run file on the given level
+	void addRun(int level)
+	{
+		if (runCount == runCapacity) {
+			runCapacity = runCapacity ? runCapacity * 2 : 8;
+			run *tmp = (run *)malloc(runCapacity * sizeof(run));
+			for (size_t i = 0; i < runCount; ++i)
+				new(tmp + i) run(runs[i]), runs[i].~run();
+			free(runs);
+			runs = tmp;
+		}
+		new(runs + runCount) run{nullptr, std::string(), nullptr, 0, 0, 0, level};
+		run &r = runs[runCount++];
+		if (directory.empty()) r.file = tmpfile();
+		else {
+			// mkstemp creates the file exclusively under a name no other process holds
+			std::string name = directory + "/sjtu_epq_XXXXXX";
+			int fd = mkstemp(&name[0]);
+			if (fd < 0) throw runtime_error();
+			r.file = fdopen(fd, "w+b");
+			if (r.file) r.path = name;
+			else {
+				close(fd);
+				std::remove(name.c_str());
+			}
+		}
+		if (!r.file) throw runtime_error();
+		r.buffer = (T *)malloc(bufferItems * sizeof(T));
+		++stats.runs_written;
+	}
+
+	// write the first n elements of the buffer of run id to its file
+	void flush(size_t id, size_t n)
+	{
+		run &r = runs[id];
+		if (fwrite(r.buffer, sizeof(T), n, r.file) != n) throw runtime_error();
+		stats.spilled_bytes += n * sizeof(T);
+		r.remain += n;
+	}
+
+	// make the finished run id readable from its start and push its first head
+	void finishRun(size_t id)
+	{
+		fflush(runs[id].file);
+		rewind(runs[id].file);
+		advance(id);
+	}
+
+	// drain the in-memory heap into a new sorted run file
+	void spill()
+	{
+		addRun(0);
+		size_t id = runCount - 1, n = 0;
+		while (!heap.empty()) {
+			runs[id].buffer[n++] = heap.top();
+			heap.pop();
+			if (n == bufferItems || heap.empty()) {
+				flush(id, n);
+				n = 0;
+			}
+		}
+		finishRun(id);
+		cascade();
+	}
+
+	// merge every run from index first on into one new run on the given level,
+	// then drop the closed runs from the array
+	void mergeFrom(size_t first, int level)
+	{
+		// split the heads into those of the merged runs and the rest
+		priority_queue<head, head_compare> part;
+		head *rest = (head *)malloc(heads.size() * sizeof(head));
+		size_t restCount = 0;
+		for (; !heads.empty(); heads.pop()) {
+			if (heads.top().id >= first) part.push(heads.top());
+			else new(rest + restCount++) head(heads.top());
+		}
+		addRun(level);
+		size_t id = runCount - 1, n = 0;
+		while (!part.empty()) {
+			head h = part.top();
+			part.pop();
+			runs[id].buffer[n++] = h.value;
+			if (n == bufferItems || part.empty()) {
+				flush(id, n);
+				n = 0;
+			}
+			const T *e = next(h.id);
+			if (e) part.push(head{*e, h.id});
+		}
+		++stats.merges;
+		// renumber the open runs, the ids held by the heads move with them
+		size_t *to = (size_t *)malloc(runCount * sizeof(size_t));
+		size_t kept = 0;
+		for (size_t i = 0; i < runCount; ++i) {
+			if (runs[i].file) {
+				to[i] = kept;
+				if (kept != i) {
+					new(runs + kept) run(runs[i]);
+					runs[i].~run();
+				}
+				++kept;
+			}
+			else runs[i].~run();
+		}
+		runCount = kept;
+		for (size_t i = 0; i < restCount; ++i) {
+			rest[i].id = to[rest[i].id];
+			heads.push(rest[i]);
+			rest[i].~head();
+		}
+		finishRun(to[id]);
+		free(to);
+		free(rest);
+	}
+
+	// merge the newest runs while fanIn of them share a level
+	void cascade()
+	{
+		for (;;) {
+			size_t count = 0, first = runCount;
+			int level = -1;
+			for (size_t i = runCount; i-- > 0 && count < fanIn; ) {
+				if (!runs[i].file) continue;
+				if (level == -1) level = runs[i].level;
+				else if (runs[i].level != level) break;
+				first = i;
+				++count;
+			}
+			if (count < fanIn) return;
+			mergeFrom(first, level + 1);
+		}
+	}
+
+	// whether the best element currently sits at the head of a run
+	bool topOnDisk() const
+	{
+		if (heads.empty()) return false;
+		return heap.empty() || Compare()(heap.top(), heads.top().value);
+	}
+
+public:
+	static const size_t DEFAULT_MEMORY_LIMIT = 64 << 20;
+	static const size_t DEFAULT_BUFFER_BYTES = 64 << 10;
+	static const size_t DEFAULT_FAN_IN = 16;
+
+	/**
+	 * memory_limit bounds the bytes held by the in-memory heap,
+	 * every open run additionally keeps a read buffer of buffer_bytes.
+	 * fan_in is the number of runs merged at once, at least 2.
+	 * runs are spilled into dir, or to tmpfile() if dir is empty.
+	 */
+	explicit external_priority_queue(const std::string &dir = ".", size_t memory_limit = DEFAULT_MEMORY_LIMIT,
+		size_t buffer_bytes = DEFAULT_BUFFER_BYTES, size_t fan_in = DEFAULT_FAN_IN):
+		runs(nullptr), runCount(0), runCapacity(0), total(0),
+		memoryLimit(memory_limit), bufferItems(buffer_bytes / sizeof(T)), fanIn(fan_in < 2 ? 2 : fan_in), directory(dir)
+	{
+		if (!bufferItems) bufferItems = 1;
+	}
+	external_priority_queue(const external_priority_queue &other) = delete;
+	external_priority_queue &operator=(const external_priority_queue &other) = delete;
+	~external_priority_queue()
+	{
+		for (size_t i = 0; i < runCount; ++i) {
+			closeRun(runs[i]);
+			runs[i].~run();
+		}
+		free(runs);
+	}
+
+	const T & top() const {
+		if (!total) throw container_is_empty();
+		return topOnDisk() ? heads.top().value : heap.top();
+	}
+	void push(const T &e) {
+		heap.push(e);
+		++total;
+		if (heap.size() * sizeof(T) > memoryLimit) spill();
+	}
+	void pop() {
+		if (!total) throw container_is_empty();
+		if (topOnDisk()) {
+			size_t id = heads.top().id;
+			heads.pop();
+			advance(id);
+		}
+		else heap.pop();
+		--total;
+	}
+	size_t size() const {
+		return total;
+	}
+	bool empty() const {
+		return !total;
+	}
+	/**
+	 * elements currently held in the in-memory heap.
+	 */
+	size_t memory_size() const {
+		return heap.size();
+	}
+	/**
+	 * run files currently open.
+	 */
+	size_t open_runs() const {
+		size_t n = 0;
+		for (size_t i = 0; i < runCount; ++i)
+			if (runs[i].file) ++n;
+		return n;
+	}
+	const statistics & stat() const {
+		return stats;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef SJTU_KEYED_PRIORITY_QUEUE_HPP
+#define SJTU_KEYED_PRIORITY_QUEUE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a priority queue ordered by a key extracted from each element.
+ *
+ * KeyOf maps an element to its priority key, it is called exactly once
+ * per pushed element. the heap keeps the key right next to the element
+ * and only compares keys, so sifting never has to look into the payload.
+ * both KeyOf and KeyCompare may carry state (for example a reference to
+ * a score table), stateless ones take no space.
+ */
+template<typename T, class KeyOf,
+	class KeyCompare = std::less<typename std::decay<decltype(std::declval<KeyOf &>()(std::declval<const T &>()))>::type>>
+class keyed_priority_queue : private functor_holder<KeyOf> {
+public:
+	using key_type = typename std::decay<decltype(std::declval<KeyOf &>()(std::declval<const T &>()))>::type;
+
+private:
+	struct entry {
+		key_type key;
+		T value;
+	};
+	class entry_compare : private functor_holder<KeyCompare> {
+	public:
+		entry_compare(const KeyCompare &c = KeyCompare()): functor_holder<KeyCompare>(c) {}
+		bool operator()(const entry &a, const entry &b) {
+			return functor_holder<KeyCompare>::get()(a.key, b.key);
+		}
+		const KeyCompare & key_comp() const {return functor_holder<KeyCompare>::get();}
+	};
+
+	priority_queue<entry, entry_compare> heap;
+
+public:
+	explicit keyed_priority_queue(const KeyOf &key_of = KeyOf(), const KeyCompare &c = KeyCompare(),
+		pop_strategy s = pop_strategy::top_down):
+		functor_holder<KeyOf>(key_of), heap(entry_compare(c), s) {}
+
+	/**
+	 * get the top of the queue.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & top() const {
+		return heap.top().value;
+	}
+	/**
+	 * the key of the top element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const key_type & top_key() const {
+		return heap.top().key;
+	}
+	/**
+	 * push new element, its key is extracted once here.
+	 */
+	void push(const T &e) {
+		heap.push(entry{functor_holder<KeyOf>::get()(e), e});
+	}
+	/**
+	 * push new element with a key the caller has already computed.
+	 */
+	void push(const key_type &key, const T &e) {
+		heap.push(entry{key, e});
+	}
+	void pop() {
+		heap.pop();
+	}
+	size_t size() const {
+		return heap.size();
+	}
+	bool empty() const {
+		return heap.empty();
+	}
+	void merge(keyed_priority_queue &other) {
+		heap.merge(other.heap);
+	}
+	const KeyCompare & key_comp() const {
+		return heap.value_comp().key_comp();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SJTU_KWAY_MERGE_HPP
+#define SJTU_KWAY_MERGE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * merge k sorted runs lazily through a heap of run cursors.
+ *
+ * every run is a pair of forward iterators [begin, end), sorted
+ * ascending by Compare, e.g. the iterators of sjtu::vector or sjtu::list.
+ * the heap holds one cursor per non-empty run, so producing the next
+ * element costs O(log k) comparisons and merging n elements O(n log k):
+ * the advanced cursor replaces the top in one pass down the heap.
+ * equal elements come out in the order of their runs, so the merge is
+ * stable. elements are read straight from the runs, nothing is copied
+ * until the caller asks for it.
+ */
+template<class Iterator,
+	class Compare = std::less<typename std::decay<decltype(*std::declval<Iterator &>())>::type>>
+class kway_merge {
+public:
+	using value_type = typename std::decay<decltype(*std::declval<Iterator &>())>::type;
+
+private:
+	struct cursor {
+		Iterator cur, end;
+		size_t run;
+	};
+	// the heap keeps the largest on top, so order cursors the other way round
+	class cursor_compare : private functor_holder<Compare> {
+	public:
+		cursor_compare(const Compare &c = Compare()): functor_holder<Compare>(c) {}
+		bool operator()(const cursor &a, const cursor &b) {
+			Compare &comp = functor_holder<Compare>::get();
+			if (comp(*b.cur, *a.cur)) return true;
+			if (comp(*a.cur, *b.cur)) return false;
+			return a.run > b.run;
+		}
+	};
+
+	priority_queue<cursor, cursor_compare> heap;
+	size_t runs;
+
+public:
+	class iterator {
+	private:
+		kway_merge *merger;
+	public:
+		// advancing consumes the merge, so it is single pass
+		using iterator_category = std::input_iterator_tag;
+		using value_type = typename kway_merge::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type *;
+		using reference = const value_type &;
+
+		explicit iterator(kway_merge *_merger = nullptr): merger(_merger) {}
+		const value_type & operator*() const {
+			return merger->top();
+		}
+		const value_type * operator->() const {
+			return &merger->top();
+		}
+		iterator & operator++() {
+			merger->pop();
+			return *this;
+		}
+		bool operator==(const iterator &rhs) const {
+			return (merger && !merger->empty() ? merger : nullptr) == (rhs.merger && !rhs.merger->empty() ? rhs.merger : nullptr);
+		}
+		bool operator!=(const iterator &rhs) const {return !(*this == rhs);}
+	};
+
+	explicit kway_merge(const Compare &c = Compare()): heap(cursor_compare(c), pop_strategy::bottom_up), runs(0) {}
+
+	/**
+	 * add a sorted run, the iterators must stay valid during the merge.
+	 */
+	void add_run(Iterator begin, Iterator end) {
+		if (begin != end) heap.push(cursor{begin, end, runs});
+		++runs;
+	}
+
+	/**
+	 * the smallest element not merged yet.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const value_type & top() const {
+		return *heap.top().cur;
+	}
+	/**
+	 * move past the smallest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop() {
+		cursor c = heap.top();
+		if (++c.cur != c.end) heap.replace_top(c);
+		else heap.pop();
+	}
+	bool empty() const {
+		return heap.empty();
+	}
+	/**
+	 * the number of runs which still have elements.
+	 */
+	size_t active_runs() const {
+		return heap.size();
+	}
+
+	/**
+	 * an input iterator over the rest of the merge, advancing it consumes the merge.
+	 */
+	iterator begin() {
+		return iterator(this);
+	}
+	iterator end() {
+		return iterator();
+	}
+
+	/**
+	 * append everything left to out (anything with push_back, e.g. sjtu::vector).
+	 */
+	template<class Container>
+	void merge_into(Container &out) {
+		while (!heap.empty()) {
+			out.push_back(top());
+			pop();
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef SJTU_MINMAX_HEAP_HPP
+#define SJTU_MINMAX_HEAP_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a double-ended priority queue (min-max heap) which keeps both the
+ * smallest and the largest element (with respect to Compare) at hand.
+ * nodes on even levels (the root is level 0) are no greater than all
+ * of their descendants, nodes on odd levels are no less than them.
+ * storage is a single 1-indexed array, grown and copied in the same
+ * way as priority_queue. the comparator object is kept for the
+ * lifetime of the heap, like priority_queue does.
+ */
+template<typename T, class Compare = std::less<T>>
+class minmax_heap : private functor_holder<Compare> {
+private:
+	T* arr;
+	int nowsize, maxsize;
+
+	Compare & comp() {return functor_holder<Compare>::get();}
+	const Compare & comp() const {return functor_holder<Compare>::get();}
+	void deleteSpace()
+	{
+		for (long long i = 1; i <= nowsize; ++i)
+			arr[i].~T();
+		free(arr);
+		nowsize = maxsize = 0;
+	}
+
+	void doubleSpace()
+	{
+		maxsize *= 2;
+		T* tmp = (T*)malloc((maxsize + 1) * sizeof(T));
+		for(long long i = 1; i <= nowsize; ++i) {
+			new(tmp + i) T(arr[i]);
+			arr[i].~T();
+		}
+		free(arr);
+		arr = tmp;
+	}
+
+	// whether node i lies on a min level
+	static bool isMinLevel(long long i)
+	{
+		int level = 0;
+		for (; i > 1; i >>= 1) ++level;
+		return !(level & 1);
+	}
+
+	// on a min level "better" means smaller, on a max level it means larger
+	bool better(const T &a, const T &b, bool minLevel)
+	{
+		return minLevel ? comp()(a, b) : comp()(b, a);
+	}
+
+	// move the element at i up through the grandparents of its own kind
+	void bubbleUp(long long hole, bool minLevel)
+	{
+		T tmp = arr[hole];
+		for (; hole > 3 && better(tmp, arr[hole/4], minLevel); hole /= 4)
+			arr[hole] = arr[hole/4];
+		arr[hole] = tmp;
+	}
+
+	void pushUp(long long i)
+	{
+		if (i == 1) return;
+		long long parent = i / 2;
+		bool minLevel = isMinLevel(i);
+		if (better(arr[parent], arr[i], minLevel)) {
+			std::swap(arr[i], arr[parent]);
+			bubbleUp(parent, !minLevel);
+		}
+		else bubbleUp(i, minLevel);
+	}
+
+	// the best of the children and grandchildren of i, 0 if i is a leaf
+	long long bestDescendant(long long i, bool minLevel)
+	{
+		long long best = 0;
+		for (long long c = i * 2; c <= i * 2 + 1 && c <= nowsize; ++c) {
+			if (!best || better(arr[c], arr[best], minLevel)) best = c;
+			for (long long g = c * 2; g <= c * 2 + 1 && g <= nowsize; ++g)
+				if (better(arr[g], arr[best], minLevel)) best = g;
+		}
+		return best;
+	}
+
+	void trickleDown(long long i)
+	{
+		bool minLevel = isMinLevel(i);
+		for (long long m = bestDescendant(i, minLevel); m; m = bestDescendant(i, minLevel)) {
+			if (!better(arr[m], arr[i], minLevel)) break;
+			std::swap(arr[i], arr[m]);
+			if (m <= i * 2 + 1) break;
+			if (better(arr[m/2], arr[m], minLevel))
+				std::swap(arr[m], arr[m/2]);
+			i = m;
+		}
+	}
+
+	long long maxIndex() const
+	{
+		if (nowsize == 1) return 1;
+		if (nowsize == 2 || !comp()(arr[2], arr[3])) return 2;
+		return 3;
+	}
+
+	void removeAt(long long i)
+	{
+		if (i != nowsize) arr[i] = arr[nowsize];
+		arr[nowsize].~T();
+		--nowsize;
+		if (i <= nowsize) trickleDown(i);
+	}
+
+public:
+	explicit minmax_heap(const Compare &c = Compare()): functor_holder<Compare>(c), nowsize(0), maxsize(100)
+	{
+		arr = (T*) malloc(101 * sizeof(T));
+	}
+	minmax_heap(const minmax_heap &other): functor_holder<Compare>(other), nowsize(other.nowsize), maxsize(other.maxsize)
+	{
+		arr = (T*)malloc((maxsize + 1) * sizeof(T));
+		for (long long i = 1; i <= nowsize; ++i)
+			new(arr+i) T(other.arr[i]);
+	}
+	~minmax_heap() {deleteSpace();}
+	minmax_heap &operator=(const minmax_heap &other)
+	{
+		if(this == &other) return *this;
+		deleteSpace();
+		functor_holder<Compare>::operator=(other);
+		nowsize = other.nowsize;
+		maxsize = other.maxsize;
+		arr = (T*)malloc((maxsize + 1) * sizeof(T));
+		for (long long i = 1; i <= nowsize; ++i)
+			new(arr+i) T(other.arr[i]);
+		return *this;
+	}
+	/**
+	 * get the smallest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & min() const {
+		if (!nowsize) throw container_is_empty();
+		return arr[1];
+	}
+	/**
+	 * get the largest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	const T & max() const {
+		if (!nowsize) throw container_is_empty();
+		return arr[maxIndex()];
+	}
+	/**
+	 * push new element to the heap.
+	 */
+	void push(const T &e) {
+		if (nowsize == maxsize) doubleSpace();
+		new(arr + nowsize + 1) T(e);
+		pushUp(++nowsize);
+	}
+	/**
+	 * delete the smallest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop_min() {
+		if (!nowsize) throw container_is_empty();
+		removeAt(1);
+	}
+	/**
+	 * delete the largest element.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void pop_max() {
+		if (!nowsize) throw container_is_empty();
+		removeAt(maxIndex());
+	}
+	size_t size() const {
+		return nowsize;
+	}
+	bool empty() const {
+		return !nowsize;
+	}
+	/**
+	 * the comparator used by this heap.
+	 */
+	const Compare & value_comp() const {
+		return comp();
+	}
+	/**
+	 * move all the elements of other into this heap, other becomes empty.
+	 */
+	void merge(minmax_heap &other) {
+		while(nowsize + other.nowsize > maxsize)
+			doubleSpace();
+		for (long long i = 1; i <= other.nowsize; ++i) {
+			new(arr + nowsize + i) T(other.arr[i]);
+			other.arr[i].~T();
+		}
+		nowsize += other.nowsize;
+		other.nowsize = 0;
+		for (long long i = nowsize/2; i >= 1; --i)
+			trickleDown(i);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef SJTU_MULTI_QUEUE_HPP
+#define SJTU_MULTI_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a concurrent relaxed priority queue (MultiQueue).
+ *
+ * the queue is made of c * p ordinary priority_queue heaps (p is the
+ * number of worker threads, c the heaps per thread), each protected by
+ * its own lock. push() puts the element into one random heap, pop()
+ * samples two random heaps and takes the top of the better one.
+ *
+ * ordering is relaxed: pop() does NOT always return the global top.
+ * with two-choice sampling the rank of a popped element among all
+ * elements present is O(c * p) in expectation, independent of the
+ * queue size, and no element is starved: every element is popped
+ * after an expected O(c * p) pops that reach its heap. when a single
+ * thread uses the queue with one heap (c * p == 1) it is exact.
+ *
+ * try_pop() reports an empty queue only after a sweep over every heap
+ * found nothing, so a false return is exact at the moment of the sweep
+ * but may be outdated when concurrent pushes are in flight.
+ */
+template<typename T, class Compare = std::less<T>>
+class multi_queue : private functor_holder<Compare> {
+private:
+	struct alignas(64) slot {
+		std::mutex lock;
+		priority_queue<T, Compare> heap;
+
+		explicit slot(const Compare &c): heap(c) {}
+	};
+
+	slot* heaps;
+	// the block heaps sits in, new[] only honours alignas(64) from c++17 on
+	void* raw;
+	size_t count;
+
+	const Compare & comp() const {return functor_holder<Compare>::get();}
+
+	static unsigned long long nextRandom()
+	{
+		static thread_local unsigned long long state =
+			std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	size_t randomIndex() const
+	{
+		return nextRandom() % count;
+	}
+
+	// pop the top of heap i if it is non-empty, the caller holds its lock
+	static bool popLocked(slot &s, T &out)
+	{
+		if (s.heap.empty()) return false;
+		out = s.heap.top();
+		s.heap.pop();
+		return true;
+	}
+
+	// sweep every heap once, used when random sampling keeps hitting empty heaps
+	bool popSweep(T &out)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			std::lock_guard<std::mutex> guard(heaps[i].lock);
+			if (popLocked(heaps[i], out)) return true;
+		}
+		return false;
+	}
+
+public:
+	static const size_t DEFAULT_FACTOR = 2;
+
+	/**
+	 * build a queue for the given number of threads with factor heaps per thread, all ordered by c.
+	 */
+	explicit multi_queue(size_t threads = std::thread::hardware_concurrency(), size_t factor = DEFAULT_FACTOR, const Compare &c = Compare()):
+		functor_holder<Compare>(c)
+	{
+		count = (threads ? threads : 1) * (factor ? factor : 1);
+		raw = malloc(count * sizeof(slot) + alignof(slot) - 1);
+		heaps = (slot *) (((size_t) raw + alignof(slot) - 1) / alignof(slot) * alignof(slot));
+		for (size_t i = 0; i < count; ++i)
+			new(heaps + i) slot(c);
+	}
+	multi_queue(const multi_queue &other) = delete;
+	multi_queue &operator=(const multi_queue &other) = delete;
+	~multi_queue()
+	{
+		for (size_t i = 0; i < count; ++i)
+			heaps[i].~slot();
+		free(raw);
+	}
+
+	/**
+	 * push new element into a random internal heap.
+	 */
+	void push(const T &e) {
+		for (;;) {
+			slot &s = heaps[randomIndex()];
+			if (!s.lock.try_lock()) continue;
+			s.heap.push(e);
+			s.lock.unlock();
+			return;
+		}
+	}
+
+	/**
+	 * pop the better top of two randomly chosen heaps into out.
+	 * return false if the whole queue was found empty.
+	 */
+	bool try_pop(T &out) {
+		if (count == 1) return popSweep(out);
+		static const int ATTEMPTS = 8;
+		for (int attempt = 0; attempt < ATTEMPTS; ) {
+			size_t i = randomIndex(), j = randomIndex();
+			if (i == j) continue;
+			if (!heaps[i].lock.try_lock()) continue;
+			if (!heaps[j].lock.try_lock()) {
+				heaps[i].lock.unlock();
+				continue;
+			}
+			priority_queue<T, Compare> &a = heaps[i].heap, &b = heaps[j].heap;
+			bool found = true;
+			if (a.empty() && b.empty()) found = false, ++attempt;
+			else if (b.empty() || (!a.empty() && !comp()(a.top(), b.top()))) popLocked(heaps[i], out);
+			else popLocked(heaps[j], out);
+			heaps[j].lock.unlock();
+			heaps[i].lock.unlock();
+			if (found) return true;
+		}
+		return popSweep(out);
+	}
+
+	/**
+	 * pop an element, throw container_is_empty if the queue was found empty.
+	 */
+	T pop() {
+		T ret;
+		if (!try_pop(ret)) throw container_is_empty();
+		return ret;
+	}
+
+	/**
+	 * the number of elements, exact only when no other thread is modifying the queue.
+	 */
+	size_t size() const {
+		size_t ret = 0;
+		for (size_t i = 0; i < count; ++i) {
+			std::lock_guard<std::mutex> guard(heaps[i].lock);
+			ret += heaps[i].heap.size();
+		}
+		return ret;
+	}
+	bool empty() const {
+		return !size();
+	}
+	const Compare & value_comp() const {
+		return comp();
+	}
+	/**
+	 * the number of internal heaps (c * p).
+	 */
+	size_t heap_count() const {
+		return count;
+	}
+};
+
+}
+
+#endif
@@ -2,147 +2,654 @@
 #define SJTU_PRIORITY_QUEUE_HPP
 
 #include <cstddef>
+#include <cstdlib>
 #include <functional>
+#include <type_traits>
+#include <utility>
 #include "exceptions.hpp"
 
 namespace sjtu {
 
 /**
- * a container like std::priority_queue which is a heap internal.
+ * how pop() restores an array heap.
+ * top_down moves the last element to the root and sifts it down, two
+ * comparisons per level. bottom_up (Floyd) first walks the larger-child
+ * path down to a leaf with one comparison per level, then sifts the last
+ * element up from there, which is usually only a level or two. prefer
+ * bottom_up when comparisons are expensive.
  */
-template<typename T, class Compare = std::less<T>>
-class priority_queue {
+enum class pop_strategy {top_down, bottom_up};
+
+/**
+ * holds a function object such as a comparator. stateless classes are
+ * kept as a base so they take no space (empty-base optimization), all
+ * others are kept as a member. final classes cannot be derived from,
+ * std::is_final is c++14 so the compiler builtin is asked instead.
+ */
+template<class F, bool = std::is_empty<F>::value && !__is_final(F)>
+class functor_holder : private F {
+public:
+	functor_holder(const F &f = F()): F(f) {}
+	F & get() {return *this;}
+	const F & get() const {return *this;}
+};
+
+template<class F>
+class functor_holder<F, false> {
+private:
+	F f;
+public:
+	functor_holder(const F &_f = F()): f(_f) {}
+	F & get() {return f;}
+	const F & get() const {return f;}
+};
+
+/**
+ * merge policies, they decide how an array heap absorbs another one.
+ * node-based heaps always meld their trees and ignore the policy.
+ *   merge_rebuild:  append the other array and heapify everything, O(n + m).
+ *   merge_insert:   push the other elements one by one, O(m log(n + m)).
+ *   merge_adaptive: whichever of the two is cheaper for the sizes at hand.
+ */
+struct merge_rebuild {};
+struct merge_insert {};
+struct merge_adaptive {};
+
+/**
+ * a growable stack used to walk node-based heaps without recursion,
+ * their trees may be as deep as they are large.
+ */
+template<class E>
+class walk_stack {
+private:
+	E* arr;
+	size_t nowsize, maxsize;
+public:
+	walk_stack(): nowsize(0), maxsize(32) {arr = (E*)malloc(maxsize * sizeof(E));}
+	walk_stack(const walk_stack &other) = delete;
+	walk_stack &operator=(const walk_stack &other) = delete;
+	~walk_stack() {free(arr);}
+	void push(const E &e) {
+		if (nowsize == maxsize) {
+			maxsize *= 2;
+			arr = (E*)realloc(arr, maxsize * sizeof(E));
+		}
+		arr[nowsize++] = e;
+	}
+	E pop() {return arr[--nowsize];}
+	bool empty() const {return !nowsize;}
+};
+
+/**
+ * an implicit D-ary heap in a 1-indexed array, D = 2 is the binary heap.
+ * the children of node i are D * (i - 1) + 2 ... D * i + 1.
+ */
+template<typename T, class Compare, int D>
+class array_heap_engine : private functor_holder<Compare> {
+	static_assert(D >= 2, "a heap node needs at least two children");
 private:
 	T* arr;
 	int nowsize, maxsize;
+	pop_strategy strategy;
+
+	Compare & comp() {return functor_holder<Compare>::get();}
+
+	static long long parent(long long i) {return (i - 2) / D + 1;}
+	static long long firstChild(long long i) {return D * (i - 1) + 2;}
+
 	void deleteSpace()
 	{
-        for (long long i = 1; i <= nowsize; ++i) 
-            arr[i].~T();
-        free(arr);
+		for (long long i = 1; i <= nowsize; ++i)
+			arr[i].~T();
+		free(arr);
 		nowsize = maxsize = 0;
-    }
+	}
 
-    void doubleSpace()
-    {
-        maxsize *= 2;
-        T* tmp = (T*)malloc((maxsize + 1) * sizeof(T));
-        for(long long i = 1; i <= nowsize; ++i) {
-            new(tmp + i) T(arr[i]);
-            arr[i].~T();
-        }
-        free(arr);
-        arr = tmp;
+	void doubleSpace()
+	{
+		maxsize *= 2;
+		T* tmp = (T*)malloc((maxsize + 1) * sizeof(T));
+		for(long long i = 1; i <= nowsize; ++i) {
+			new(tmp + i) T(arr[i]);
+			arr[i].~T();
+		}
+		free(arr);
+		arr = tmp;
+	}
+
+	void copyFrom(const array_heap_engine &other)
+	{
+		nowsize = other.nowsize;
+		maxsize = other.maxsize;
+		strategy = other.strategy;
+		arr = (T*)malloc((maxsize + 1) * sizeof(T));
+		for (long long i = 1; i <= nowsize; ++i)
+			new(arr+i) T(other.arr[i]);
+	}
+
+	// the best child of hole, 0 if hole is a leaf
+	long long bestChild(long long hole)
+	{
+		long long child = firstChild(hole);
+		if (child > nowsize) return 0;
+		long long last = child + D - 1 < nowsize ? child + D - 1 : nowsize;
+		for (long long k = child + 1; k <= last; ++k)
+			if (comp()(arr[child], arr[k])) child = k;
+		return child;
 	}
 
 	void perlocateDown(long long i)
 	{
 		long long hole = i;
 		T tmp = arr[hole];
+		for (long long child = bestChild(hole); child; child = bestChild(hole)) {
+			if (!comp()(tmp, arr[child])) break;
+			arr[hole] = arr[child];
+			hole = child;
+		}
+		arr[hole] = tmp;
+	}
 
-		long long child;
-		for (; hole * 2 <= nowsize; hole = child) {
-			child = hole * 2;
-			if (child < nowsize && Compare() (arr[child], arr[child+1])) 
-				child += 1;
-			if (Compare() (tmp, arr[child]))
-				arr[hole] = arr[child];
-			else break; 
+	// remove arr[1] along the best-child path, then sift the last element up
+	void popBottomUp()
+	{
+		T tmp = arr[nowsize];
+		arr[nowsize].~T();
+		if (!--nowsize) return;
+
+		long long hole = 1;
+		for (long long child = bestChild(hole); child; child = bestChild(hole)) {
+			arr[hole] = arr[child];
+			hole = child;
 		}
+		for (; hole > 1 && comp()(arr[parent(hole)], tmp); hole = parent(hole))
+			arr[hole] = arr[parent(hole)];
 		arr[hole] = tmp;
 	}
 
+	void mergeRebuild(array_heap_engine &other)
+	{
+		while(nowsize + other.nowsize > maxsize)
+			doubleSpace();
+		for (long long i = 1; i <= other.nowsize; ++i) {
+			new(arr + nowsize + i) T(other.arr[i]);
+			other.arr[i].~T();
+		}
+		nowsize += other.nowsize;
+		other.nowsize = 0;
+		for (long long i = parent(nowsize); i >= 1; --i)
+			perlocateDown(i);
+	}
+
+	void mergeInsert(array_heap_engine &other)
+	{
+		for (long long i = 1; i <= other.nowsize; ++i) {
+			push(other.arr[i]);
+			other.arr[i].~T();
+		}
+		other.nowsize = 0;
+	}
+
 public:
-	/**
-	 * TODO constructors
-	 */
-	priority_queue(): nowsize(0), maxsize(100) {arr = (T*) malloc(101 * sizeof(T));}
-	priority_queue(const priority_queue &other): nowsize(other.nowsize), maxsize(other.maxsize) 
+	explicit array_heap_engine(const Compare &c = Compare(), pop_strategy s = pop_strategy::top_down):
+		functor_holder<Compare>(c), nowsize(0), maxsize(100), strategy(s)
 	{
-		arr = (T*)malloc((maxsize + 1) * sizeof(T));
-		for (long long i = 1; i <= nowsize; ++i) 
-			new(arr+i) T(other.arr[i]);
+		arr = (T*) malloc(101 * sizeof(T));
 	}
-	/**
-	 * TODO deconstructor
-	 */
-	~priority_queue() {deleteSpace();}
-	/**
-	 * TODO Assignment operator
-	 */
-	priority_queue &operator=(const priority_queue &other) 
+	array_heap_engine(const array_heap_engine &other): functor_holder<Compare>(other) {copyFrom(other);}
+	~array_heap_engine() {deleteSpace();}
+	array_heap_engine &operator=(const array_heap_engine &other)
 	{
 		if(this == &other) return *this;
 		deleteSpace();
-		nowsize = other.nowsize;
-		maxsize = other.maxsize;
-		arr = (T*)malloc((maxsize + 1) * sizeof(T));
-		for (long long i = 1; i <= nowsize; ++i) 
-			new(arr+i) T(other.arr[i]);
+		functor_holder<Compare>::operator=(other);
+		copyFrom(other);
+		return *this;
+	}
+
+	const T & top() const {
+		if (!nowsize) throw container_is_empty();
+		return arr[1];
+	}
+	void push(const T &e) {
+		if (nowsize == maxsize) doubleSpace();
+
+		new(arr + nowsize + 1) T(e);
+		long long hole = ++nowsize;
+		for(; hole > 1 && !comp()(e, arr[parent(hole)]); hole = parent(hole))
+			arr[hole] = arr[parent(hole)];
+		arr[hole] = e;
+	}
+	void pop() {
+		if (!nowsize) throw container_is_empty();
+		if (strategy == pop_strategy::bottom_up) {
+			popBottomUp();
+			return;
+		}
+
+		arr[1] = arr[nowsize];
+		arr[nowsize].~T();
+		--nowsize;
+		if (nowsize) perlocateDown(1);
+	}
+	void replace_top(const T &e) {
+		if (!nowsize) throw container_is_empty();
+		if (strategy == pop_strategy::top_down) {
+			arr[1] = e;
+			perlocateDown(1);
+			return;
+		}
+		// the hole walks down the best-child path, then e sifts up from the leaf
+		T tmp = e;
+		long long hole = 1;
+		for (long long child = bestChild(hole); child; child = bestChild(hole)) {
+			arr[hole] = arr[child];
+			hole = child;
+		}
+		for (; hole > 1 && comp()(arr[parent(hole)], tmp); hole = parent(hole))
+			arr[hole] = arr[parent(hole)];
+		arr[hole] = tmp;
+	}
+	size_t size() const {return nowsize;}
+	bool empty() const {return !nowsize;}
+
+	void merge(array_heap_engine &other, merge_rebuild) {
+		if (this != &other) mergeRebuild(other);
+	}
+	void merge(array_heap_engine &other, merge_insert) {
+		if (this != &other) mergeInsert(other);
+	}
+	void merge(array_heap_engine &other, merge_adaptive) {
+		if (this == &other) return;
+		long long total = nowsize + other.nowsize, depth = 1;
+		for (long long k = total; k >= D; k /= D) ++depth;
+		if (other.nowsize * depth < total) mergeInsert(other);
+		else mergeRebuild(other);
+	}
+
+	void set_pop_strategy(pop_strategy s) {strategy = s;}
+	pop_strategy get_pop_strategy() const {return strategy;}
+	const Compare & value_comp() const {return functor_holder<Compare>::get();}
+};
+
+/**
+ * a pairing heap: push and merge are O(1), pop is amortized O(log n)
+ * with the two-pass pairing of the root's children.
+ */
+template<typename T, class Compare>
+class pairing_heap_engine : private functor_holder<Compare> {
+private:
+	struct node {
+		T data;
+		node *child, *sibling;
+	};
+	node *root;
+	size_t len;
+
+	Compare & comp() {return functor_holder<Compare>::get();}
+
+	// link two roots, the one with the worse element becomes the first child
+	node *link(node *a, node *b)
+	{
+		if (comp()(a->data, b->data)) std::swap(a, b);
+		b->sibling = a->child;
+		a->child = b;
+		return a;
+	}
+
+	// two-pass pairing of a sibling list
+	node *combine(node *first)
+	{
+		if (!first) return nullptr;
+		node *pairs = nullptr;
+		while (first) {
+			node *a = first, *b = a->sibling;
+			if (!b) {
+				a->sibling = pairs;
+				pairs = a;
+				break;
+			}
+			first = b->sibling;
+			a->sibling = b->sibling = nullptr;
+			node *m = link(a, b);
+			m->sibling = pairs;
+			pairs = m;
+		}
+		node *ret = pairs;
+		pairs = pairs->sibling;
+		ret->sibling = nullptr;
+		while (pairs) {
+			node *next = pairs->sibling;
+			pairs->sibling = nullptr;
+			ret = link(ret, pairs);
+			pairs = next;
+		}
+		return ret;
+	}
+
+	void deleteSpace()
+	{
+		node *work = root;
+		while (work) {
+			node *p = work;
+			work = p->sibling;
+			if (p->child) {
+				node *last = p->child;
+				while (last->sibling) last = last->sibling;
+				last->sibling = work;
+				work = p->child;
+			}
+			delete p;
+		}
+		root = nullptr;
+		len = 0;
+	}
+
+	void copyFrom(const pairing_heap_engine &other)
+	{
+		len = other.len;
+		root = nullptr;
+		if (!other.root) return;
+		struct task {
+			const node *from;
+			node *to;
+		};
+		walk_stack<task> todo;
+		root = new node{other.root->data, nullptr, nullptr};
+		todo.push(task{other.root, root});
+		while (!todo.empty()) {
+			task t = todo.pop();
+			if (t.from->child) {
+				t.to->child = new node{t.from->child->data, nullptr, nullptr};
+				todo.push(task{t.from->child, t.to->child});
+			}
+			if (t.from->sibling) {
+				t.to->sibling = new node{t.from->sibling->data, nullptr, nullptr};
+				todo.push(task{t.from->sibling, t.to->sibling});
+			}
+		}
+	}
+
+public:
+	explicit pairing_heap_engine(const Compare &c = Compare(), pop_strategy = pop_strategy::top_down):
+		functor_holder<Compare>(c), root(nullptr), len(0) {}
+	pairing_heap_engine(const pairing_heap_engine &other): functor_holder<Compare>(other) {copyFrom(other);}
+	~pairing_heap_engine() {deleteSpace();}
+	pairing_heap_engine &operator=(const pairing_heap_engine &other)
+	{
+		if(this == &other) return *this;
+		deleteSpace();
+		functor_holder<Compare>::operator=(other);
+		copyFrom(other);
+		return *this;
+	}
+
+	const T & top() const {
+		if (!len) throw container_is_empty();
+		return root->data;
+	}
+	void push(const T &e) {
+		node *p = new node{e, nullptr, nullptr};
+		root = root ? link(root, p) : p;
+		++len;
+	}
+	void pop() {
+		if (!len) throw container_is_empty();
+		node *p = root;
+		root = combine(p->child);
+		delete p;
+		--len;
+	}
+	void replace_top(const T &e) {
+		T tmp = e;
+		pop();
+		push(tmp);
+	}
+	size_t size() const {return len;}
+	bool empty() const {return !len;}
+
+	template<class Merge>
+	void merge(pairing_heap_engine &other, Merge) {
+		if (this == &other || !other.root) return;
+		root = root ? link(root, other.root) : other.root;
+		len += other.len;
+		other.root = nullptr;
+		other.len = 0;
+	}
+
+	void set_pop_strategy(pop_strategy) {}
+	pop_strategy get_pop_strategy() const {return pop_strategy::top_down;}
+	const Compare & value_comp() const {return functor_holder<Compare>::get();}
+};
+
+/**
+ * a leftist heap: push, pop and merge are all O(log n) worst case,
+ * melding walks only the short right spines.
+ */
+template<typename T, class Compare>
+class leftist_heap_engine : private functor_holder<Compare> {
+private:
+	struct node {
+		T data;
+		node *left, *right;
+		int dist;
+	};
+	node *root;
+	size_t len;
+
+	Compare & comp() {return functor_holder<Compare>::get();}
+
+	static int dist(node *p) {return p ? p->dist : 0;}
+
+	node *meld(node *a, node *b)
+	{
+		if (!a) return b;
+		if (!b) return a;
+		if (comp()(a->data, b->data)) std::swap(a, b);
+		a->right = meld(a->right, b);
+		if (dist(a->left) < dist(a->right)) std::swap(a->left, a->right);
+		a->dist = dist(a->right) + 1;
+		return a;
+	}
+
+	void deleteSpace()
+	{
+		walk_stack<node *> todo;
+		if (root) todo.push(root);
+		while (!todo.empty()) {
+			node *p = todo.pop();
+			if (p->left) todo.push(p->left);
+			if (p->right) todo.push(p->right);
+			delete p;
+		}
+		root = nullptr;
+		len = 0;
+	}
+
+	void copyFrom(const leftist_heap_engine &other)
+	{
+		len = other.len;
+		root = nullptr;
+		if (!other.root) return;
+		struct task {
+			const node *from;
+			node *to;
+		};
+		walk_stack<task> todo;
+		root = new node{other.root->data, nullptr, nullptr, other.root->dist};
+		todo.push(task{other.root, root});
+		while (!todo.empty()) {
+			task t = todo.pop();
+			if (t.from->left) {
+				t.to->left = new node{t.from->left->data, nullptr, nullptr, t.from->left->dist};
+				todo.push(task{t.from->left, t.to->left});
+			}
+			if (t.from->right) {
+				t.to->right = new node{t.from->right->data, nullptr, nullptr, t.from->right->dist};
+				todo.push(task{t.from->right, t.to->right});
+			}
+		}
+	}
+
+public:
+	explicit leftist_heap_engine(const Compare &c = Compare(), pop_strategy = pop_strategy::top_down):
+		functor_holder<Compare>(c), root(nullptr), len(0) {}
+	leftist_heap_engine(const leftist_heap_engine &other): functor_holder<Compare>(other) {copyFrom(other);}
+	~leftist_heap_engine() {deleteSpace();}
+	leftist_heap_engine &operator=(const leftist_heap_engine &other)
+	{
+		if(this == &other) return *this;
+		deleteSpace();
+		functor_holder<Compare>::operator=(other);
+		copyFrom(other);
 		return *this;
 	}
+
+	const T & top() const {
+		if (!len) throw container_is_empty();
+		return root->data;
+	}
+	void push(const T &e) {
+		root = meld(root, new node{e, nullptr, nullptr, 1});
+		++len;
+	}
+	void pop() {
+		if (!len) throw container_is_empty();
+		node *p = root;
+		root = meld(p->left, p->right);
+		delete p;
+		--len;
+	}
+	void replace_top(const T &e) {
+		T tmp = e;
+		pop();
+		push(tmp);
+	}
+	size_t size() const {return len;}
+	bool empty() const {return !len;}
+
+	template<class Merge>
+	void merge(leftist_heap_engine &other, Merge) {
+		if (this == &other) return;
+		root = meld(root, other.root);
+		len += other.len;
+		other.root = nullptr;
+		other.len = 0;
+	}
+
+	void set_pop_strategy(pop_strategy) {}
+	pop_strategy get_pop_strategy() const {return pop_strategy::top_down;}
+	const Compare & value_comp() const {return functor_holder<Compare>::get();}
+};
+
+/**
+ * storage policies, they pick the engine behind priority_queue.
+ */
+template<int D>
+struct dary_heap {
+	template<typename T, class Compare>
+	using engine = array_heap_engine<T, Compare, D>;
+};
+using binary_heap = dary_heap<2>;
+struct pairing_heap {
+	template<typename T, class Compare>
+	using engine = pairing_heap_engine<T, Compare>;
+};
+struct leftist_heap {
+	template<typename T, class Compare>
+	using engine = leftist_heap_engine<T, Compare>;
+};
+
+/**
+ * a container like std::priority_queue which is a heap internal.
+ * Storage selects the heap (binary_heap, dary_heap<D>, pairing_heap,
+ * leftist_heap), Merge how merge() combines array heaps.
+ */
+template<typename T, class Compare = std::less<T>, class Storage = binary_heap, class Merge = merge_rebuild>
+class priority_queue {
+private:
+	using engine = typename Storage::template engine<T, Compare>;
+	engine heap;
+
+public:
+	/**
+	 * pop_strategy only affects the array heaps.
+	 */
+	explicit priority_queue(pop_strategy s = pop_strategy::top_down): heap(Compare(), s) {}
+	/**
+	 * use the given comparator object, which is kept for the lifetime of the queue.
+	 */
+	explicit priority_queue(const Compare &c, pop_strategy s = pop_strategy::top_down): heap(c, s) {}
+	priority_queue(const priority_queue &other) = default;
+	priority_queue &operator=(const priority_queue &other) = default;
+	~priority_queue() = default;
+
 	/**
 	 * get the top of the queue.
 	 * @return a reference of the top element.
 	 * throw container_is_empty if empty() returns true;
 	 */
 	const T & top() const {
-		if (!nowsize) throw container_is_empty();
-		return arr[1];
+		return heap.top();
 	}
 	/**
-	 * TODO
 	 * push new element to the priority queue.
 	 */
 	void push(const T &e) {
-		if (nowsize == maxsize) doubleSpace();
-		
-		new(arr + nowsize + 1) T(e);
-		long long hole = ++nowsize;
-		for(; hole > 1 && !Compare()(e, arr[hole/2]); hole /= 2)
-			arr[hole] = arr[hole/2];
-		arr[hole] = e;
+		heap.push(e);
 	}
 	/**
-	 * TODO
 	 * delete the top element.
 	 * throw container_is_empty if empty() returns true;
 	 */
 	void pop() {
-		if (!nowsize) throw container_is_empty();
-
-		arr[1] = arr[nowsize];
-		arr[nowsize].~T();
-		--nowsize;
-		perlocateDown(1);
+		heap.pop();
+	}
+	/**
+	 * replace the top element with e, as pop() then push(e) would. the
+	 * array heaps do it in one pass down from the root, following
+	 * pop_strategy; the node heaps pop and push.
+	 * throw container_is_empty if empty() returns true;
+	 */
+	void replace_top(const T &e) {
+		heap.replace_top(e);
 	}
 	/**
 	 * return the number of the elements.
 	 */
 	size_t size() const {
-		return nowsize;
+		return heap.size();
 	}
 	/**
 	 * check if the container has at least an element.
 	 * @return true if it is empty, false if it has at least an element.
 	 */
 	bool empty() const {
-		return !nowsize;
+		return heap.empty();
 	}
+	/**
+	 * choose how pop() restores an array heap, see pop_strategy.
+	 */
+	void set_pop_strategy(pop_strategy s) {
+		heap.set_pop_strategy(s);
+	}
+	pop_strategy get_pop_strategy() const {
+		return heap.get_pop_strategy();
+	}
+	/**
+	 * the comparator used by this queue.
+	 */
+	const Compare & value_comp() const {
+		return heap.value_comp();
+	}
+	/**
+	 * move all the elements of other into this queue, other becomes empty.
+	 */
 	void merge(priority_queue &other) {
-		while(nowsize + other.nowsize > maxsize)
-			doubleSpace();
-		for (long long i = 1; i <= other.nowsize; ++i) 
-			arr[nowsize + i] = other.arr[i];
-		nowsize += other.nowsize;
-		for (long long i = nowsize/2; i >= 1; --i)
-			perlocateDown(i);
-		for (long long i = 1; i <= other.nowsize; ++i) 
-            arr[i].~T();
-		other.nowsize = 0;
+		heap.merge(other.heap, Merge());
 	}
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,317 @@
+#ifndef SJTU_TIMER_WHEEL_HPP
+#define SJTU_TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+
+namespace sjtu {
+
+/**
+ * a hierarchical timing wheel for deadlines measured in integer ticks.
+ *
+ * four wheels of 256 slots cover 2^32 ticks ahead of the current time,
+ * a timer sits in the lowest wheel whose higher bits agree with the
+ * current time and cascades down as time moves on. deadlines beyond the
+ * last wheel fall back to a priority_queue ordered by deadline.
+ *
+ * schedule() and cancel() are O(1), timers in the same slot are doubly
+ * linked through indices into one node array. advance(now) jumps over
+ * empty slots with per-wheel occupancy bitmaps and fires every expired
+ * callback, one slot at a time. cancelled timers in the fallback heap
+ * are discarded lazily when they reach its top.
+ */
+template<class Callback = std::function<void()>>
+class timer_wheel {
+public:
+	using tick_type = unsigned long long;
+	using timer_id = unsigned long long;
+
+private:
+	static const int LEVELS = 4, BITS = 8, SLOTS = 1 << BITS, WORDS = SLOTS / 64;
+	// list ids besides level * SLOTS + slot
+	static const int FREE = -1, PENDING = LEVELS * SLOTS, FIRING = PENDING + 1, OVERFLOW = PENDING + 2, LISTS = PENDING + 2;
+
+	struct node {
+		tick_type deadline;
+		Callback callback;
+		int pre, nex, list;
+		unsigned gen;
+	};
+	struct far_timer {
+		tick_type deadline;
+		int idx;
+		unsigned gen;
+	};
+	struct later_first {
+		bool operator()(const far_timer &a, const far_timer &b) const {return a.deadline > b.deadline;}
+	};
+
+	node *nodes;
+	int nowsize, maxsize, freeHead;
+	int head[LISTS];
+	unsigned long long occupied[LEVELS][WORDS];
+	priority_queue<far_timer, later_first> far;
+	tick_type current;
+	size_t active;
+
+	void doubleSpace()
+	{
+		maxsize *= 2;
+		node* tmp = (node*)malloc(maxsize * sizeof(node));
+		for (int i = 0; i < nowsize; ++i) {
+			new(tmp + i) node(nodes[i]);
+			nodes[i].~node();
+		}
+		free(nodes);
+		nodes = tmp;
+	}
+
+	int allocNode()
+	{
+		if (freeHead != -1) {
+			int idx = freeHead;
+			freeHead = nodes[idx].nex;
+			return idx;
+		}
+		if (nowsize == maxsize) doubleSpace();
+		new(nodes + nowsize) node{0, Callback(), -1, -1, FREE, 0};
+		return nowsize++;
+	}
+
+	void releaseNode(int idx)
+	{
+		node &p = nodes[idx];
+		p.callback = Callback();
+		p.list = FREE;
+		++p.gen;
+		p.nex = freeHead;
+		freeHead = idx;
+	}
+
+	void link(int idx, int list)
+	{
+		node &p = nodes[idx];
+		p.list = list;
+		p.pre = -1;
+		p.nex = head[list];
+		if (p.nex != -1) nodes[p.nex].pre = idx;
+		head[list] = idx;
+		if (list < PENDING) occupied[list / SLOTS][list % SLOTS / 64] |= 1ULL << (list % 64);
+	}
+
+	void unlink(int idx)
+	{
+		node &p = nodes[idx];
+		if (p.pre != -1) nodes[p.pre].nex = p.nex;
+		else head[p.list] = p.nex;
+		if (p.nex != -1) nodes[p.nex].pre = p.pre;
+		if (p.list < PENDING && head[p.list] == -1)
+			occupied[p.list / SLOTS][p.list % SLOTS / 64] &= ~(1ULL << (p.list % 64));
+	}
+
+	// put a timer in the wheel matching its deadline relative to current
+	void place(int idx)
+	{
+		tick_type d = nodes[idx].deadline;
+		if (d <= current) {
+			link(idx, PENDING);
+			return;
+		}
+		for (int level = 0; level < LEVELS; ++level)
+			if ((d >> (BITS * (level + 1))) == (current >> (BITS * (level + 1)))) {
+				link(idx, level * SLOTS + (int)((d >> (BITS * level)) & (SLOTS - 1)));
+				return;
+			}
+		nodes[idx].list = OVERFLOW;
+		far.push(far_timer{d, idx, nodes[idx].gen});
+	}
+
+	// re-place every timer of one slot, they all move to lower wheels
+	void cascade(int level, int slot)
+	{
+		int list = level * SLOTS + slot;
+		while (head[list] != -1) {
+			int idx = head[list];
+			unlink(idx);
+			place(idx);
+		}
+	}
+
+	// drop cancelled timers from the top of the fallback heap
+	void dropStale()
+	{
+		while (!far.empty() && (nodes[far.top().idx].list != OVERFLOW || nodes[far.top().idx].gen != far.top().gen))
+			far.pop();
+	}
+
+	void pullFar()
+	{
+		while (!far.empty()) {
+			far_timer t = far.top();
+			if (nodes[t.idx].list != OVERFLOW || nodes[t.idx].gen != t.gen) {
+				far.pop();
+				continue;
+			}
+			if ((t.deadline >> (BITS * LEVELS)) != (current >> (BITS * LEVELS))) break;
+			far.pop();
+			place(t.idx);
+		}
+	}
+
+	// cascade the higher wheels when current crossed a slot boundary of wheel 0
+	void crossBoundary()
+	{
+		int level = 1;
+		while (level < LEVELS && !((current >> (BITS * level)) & (SLOTS - 1))) ++level;
+		if (level == LEVELS) {
+			pullFar();
+			--level;
+		}
+		for (; level >= 1; --level)
+			cascade(level, (int)((current >> (BITS * level)) & (SLOTS - 1)));
+	}
+
+	// first occupied slot of a wheel after the given slot, -1 if none
+	int nextOccupied(int level, int after) const
+	{
+		for (int s = after + 1; s < SLOTS; ) {
+			unsigned long long word = occupied[level][s / 64] >> (s % 64);
+			if (word) return s + __builtin_ctzll(word);
+			s = (s / 64 + 1) * 64;
+		}
+		return -1;
+	}
+
+	// the first tick after current at which some slot fires or cascades
+	tick_type nextEvent() const
+	{
+		tick_type best = ~0ULL;
+		for (int level = 0; level < LEVELS; ++level) {
+			int shift = BITS * level;
+			int s = nextOccupied(level, (int)((current >> shift) & (SLOTS - 1)));
+			if (s == -1) continue;
+			tick_type base = current >> (shift + BITS) << (shift + BITS);
+			tick_type t = base + ((tick_type)s << shift);
+			if (t < best) best = t;
+		}
+		if (!far.empty()) {
+			const int shift = BITS * LEVELS;
+			tick_type t = (far.top().deadline >> shift) << shift;
+			if (t < best) best = t;
+		}
+		return best;
+	}
+
+	size_t fire(int list)
+	{
+		size_t fired = 0;
+		while (head[list] != -1) {
+			int idx = head[list];
+			unlink(idx);
+			link(idx, FIRING);
+		}
+		while (head[FIRING] != -1) {
+			int idx = head[FIRING];
+			unlink(idx);
+			Callback cb = std::move(nodes[idx].callback);
+			releaseNode(idx);
+			--active;
+			++fired;
+			cb();
+		}
+		return fired;
+	}
+
+public:
+	explicit timer_wheel(tick_type now = 0): nowsize(0), maxsize(64), freeHead(-1), current(now), active(0)
+	{
+		nodes = (node*)malloc(maxsize * sizeof(node));
+		std::fill(head, head + LISTS, -1);
+		for (int level = 0; level < LEVELS; ++level)
+			std::fill(occupied[level], occupied[level] + WORDS, 0ULL);
+	}
+	timer_wheel(const timer_wheel &other) = delete;
+	timer_wheel &operator=(const timer_wheel &other) = delete;
+	~timer_wheel()
+	{
+		for (int i = 0; i < nowsize; ++i)
+			nodes[i].~node();
+		free(nodes);
+	}
+
+	/**
+	 * run callback at the first advance() reaching deadline.
+	 * a deadline which has already passed fires at the next advance().
+	 * return an id for cancel().
+	 */
+	timer_id schedule(tick_type deadline, const Callback &callback) {
+		int idx = allocNode();
+		nodes[idx].deadline = deadline;
+		nodes[idx].callback = callback;
+		place(idx);
+		++active;
+		return (timer_id)nodes[idx].gen << 32 | (unsigned)idx;
+	}
+
+	/**
+	 * cancel a timer which has not fired yet.
+	 * return false if it has already fired or been cancelled.
+	 */
+	bool cancel(timer_id id) {
+		int idx = (int)(id & 0xffffffffu);
+		if (idx < 0 || idx >= nowsize) return false;
+		node &p = nodes[idx];
+		if (p.list == FREE || p.gen != (unsigned)(id >> 32)) return false;
+		if (p.list != OVERFLOW) unlink(idx);
+		releaseNode(idx);
+		--active;
+		return true;
+	}
+
+	/**
+	 * move the current time forward to now and fire every timer whose
+	 * deadline is no later than now. return the number of fired timers.
+	 */
+	size_t advance(tick_type now) {
+		size_t fired = fire(PENDING);
+		while (current < now) {
+			dropStale();
+			// nothing is due before now, so no timer has to move to another wheel either.
+			// test active on its own, now may be the largest tick and now + 1 wrap to 0
+			tick_type next = active ? nextEvent() : now;
+			if (!active || next > now) {
+				current = now;
+				break;
+			}
+			tick_type from = current;
+			current = next;
+			if ((from ^ current) >> BITS) crossBoundary();
+			fired += fire((int)(current & (SLOTS - 1)));
+			fired += fire(PENDING);
+		}
+		fired += fire(PENDING);
+		return fired;
+	}
+
+	tick_type now() const {
+		return current;
+	}
+	/**
+	 * the number of timers which have neither fired nor been cancelled.
+	 */
+	size_t size() const {
+		return active;
+	}
+	bool empty() const {
+		return !active;
+	}
+};
+
+}
+
+#endif